@@ -5,6 +5,7 @@
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <gl/debug.hpp>
 #include <gl/shaders.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <primitives.hpp>
@@ -603,6 +604,8 @@ void main()
         glm::lookAt(glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 0.0f, -1.0f), glm::vec3(0.0f, -1.0f, 0.0f))};
 
 
+    gl::debug_group group("specular ibl");
+
     uint32_t fb, rbo;
     glGenFramebuffers(1, &fb);
     glGenRenderbuffers(1, &rbo);
@@ -612,7 +615,7 @@ void main()
     glEnable(GL_DEPTH_TEST);
     glEnable(GL_TEXTURE_CUBE_MAP_SEAMLESS);
 
-    assert(glGetError() == GL_NO_ERROR);
+    GL_CHECK_ERRORS();
 
     size_t max_mip_levels = 5;
 
@@ -653,6 +656,6 @@ void main()
     glDeleteFramebuffers(1, &fb);
     glDeleteRenderbuffers(1, &rbo);
 
-    assert(glGetError() == GL_NO_ERROR);
+    GL_CHECK_ERRORS();
     return {std::move(cube_tex), std::move(brdf_tex)};
 }
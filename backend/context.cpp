@@ -0,0 +1,56 @@
+
+
+#include "context.hpp"
+
+#include <third/tinygltf/stb_image_write.h>
+
+#include <iostream>
+#include <stdexcept>
+
+
+std::vector<uint8_t> backend::context::read_pixels() const
+{
+    const auto [width, height] = get_surface_size();
+    std::vector<uint8_t> pixels(size_t(width) * height * 4);
+
+    int32_t read_fb;
+    glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &read_fb);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, get_surface_framebuffer());
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_PACK_ALIGNMENT, 4);
+
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, read_fb);
+    GL_CHECK_ERRORS();
+
+    return pixels;
+}
+
+
+void backend::context::write_png(const std::string& path) const
+{
+    const auto [width, height] = get_surface_size();
+    const auto pixels = read_pixels();
+
+    // gl rows go bottom to top.
+    stbi_flip_vertically_on_write(1);
+
+    if (stbi_write_png(path.c_str(), width, height, 4, pixels.data(), width * 4) == 0) {
+        throw std::runtime_error("failed to write " + path);
+    }
+}
+
+
+void backend::context::load_gl(gl::proc_loader load)
+{
+    if (!gladLoadGLLoader(reinterpret_cast<GLADloadproc>(load))) {
+        throw std::runtime_error("failed to load gl");
+    }
+
+    if constexpr (gl::debug_build) {
+        if (!gl::enable_debug_output(load)) {
+            std::cout << "KHR_debug is not available, gl errors are polled" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,41 @@
+
+
+#pragma once
+
+#include <gl/debug.hpp>
+
+#include <cinttypes>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace backend
+{
+    // gl context and the surface frames are presented to. gl is loaded and the context is current
+    // once a backend is constructed, the scene has to be destroyed before the backend.
+    class context
+    {
+    public:
+        context() = default;
+        virtual ~context() = default;
+
+        context(const context&) = delete;
+        context& operator=(const context&) = delete;
+
+        virtual bool should_close() const = 0;
+        virtual std::pair<uint32_t, uint32_t> get_surface_size() const = 0;
+        // framebuffer the frame is blitted to, 0 is the default framebuffer of a window.
+        virtual uint32_t get_surface_framebuffer() const = 0;
+        // swaps a window or waits for an offscreen frame, polls events.
+        virtual void present() = 0;
+
+        // rgba8 rows of the surface, bottom row first. read before present, the back buffer of a window
+        // is undefined after the swap.
+        std::vector<uint8_t> read_pixels() const;
+        void write_png(const std::string& path) const;
+
+    protected:
+        // loads gl entry points of the current context, enables debug output in debug builds.
+        static void load_gl(gl::proc_loader load);
+    };
+} // namespace backend
@@ -0,0 +1,207 @@
+
+
+#include "egl_context.hpp"
+
+#include <EGL/eglext.h>
+
+#include <cassert>
+#include <cstring>
+#include <stdexcept>
+
+namespace
+{
+    bool has_egl_extension(EGLDisplay display, const char* name)
+    {
+        const char* extensions = eglQueryString(display, EGL_EXTENSIONS);
+
+        if (extensions == nullptr) {
+            return false;
+        }
+
+        const auto length = std::strlen(name);
+
+        for (const char* it = std::strstr(extensions, name); it != nullptr; it = std::strstr(it + length, name)) {
+            if ((it == extensions || it[-1] == ' ') && (it[length] == ' ' || it[length] == '\0')) {
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+
+    void* get_proc_address(const char* name)
+    {
+        return reinterpret_cast<void*>(eglGetProcAddress(name));
+    }
+} // namespace
+
+
+backend::egl_context::egl_context(uint32_t width, uint32_t height, uint32_t frames)
+    : m_display(get_display())
+    , m_width(width)
+    , m_height(height)
+    , m_frames(frames)
+{
+    assert(width > 0 && height > 0);
+
+    if (!eglInitialize(m_display, nullptr, nullptr)) {
+        throw std::runtime_error("failed to initialize egl display");
+    }
+
+    const EGLint config_attributes[]{
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8,
+        EGL_GREEN_SIZE, 8,
+        EGL_BLUE_SIZE, 8,
+        EGL_ALPHA_SIZE, 8,
+        EGL_DEPTH_SIZE, 24,
+        EGL_NONE};
+
+    EGLConfig config;
+    EGLint configs_count = 0;
+
+    if (!eglChooseConfig(m_display, config_attributes, &config, 1, &configs_count) || configs_count == 0) {
+        eglTerminate(m_display);
+        throw std::runtime_error("no egl config with desktop gl and pbuffers");
+    }
+
+    eglBindAPI(EGL_OPENGL_API);
+
+    const EGLint context_attributes[]{
+        EGL_CONTEXT_MAJOR_VERSION, 4,
+        EGL_CONTEXT_MINOR_VERSION, 1,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_CONTEXT_OPENGL_DEBUG, gl::debug_build ? EGL_TRUE : EGL_FALSE,
+        EGL_NONE};
+
+    m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, context_attributes);
+
+    if (m_context == EGL_NO_CONTEXT) {
+        eglTerminate(m_display);
+        throw std::runtime_error("failed to create a 4.1 core egl context");
+    }
+
+    // nothing is drawn to the surface, frames go to the offscreen framebuffer.
+    if (!has_egl_extension(m_display, "EGL_KHR_surfaceless_context")) {
+        const EGLint surface_attributes[]{EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        m_surface = eglCreatePbufferSurface(m_display, config, surface_attributes);
+
+        if (m_surface == EGL_NO_SURFACE) {
+            eglDestroyContext(m_display, m_context);
+            eglTerminate(m_display);
+            throw std::runtime_error("failed to create an egl pbuffer");
+        }
+    }
+
+    if (!eglMakeCurrent(m_display, m_surface, m_surface, m_context)) {
+        if (m_surface != EGL_NO_SURFACE) {
+            eglDestroySurface(m_display, m_surface);
+        }
+        eglDestroyContext(m_display, m_context);
+        eglTerminate(m_display);
+        throw std::runtime_error("failed to make the egl context current");
+    }
+
+    load_gl(get_proc_address);
+
+    auto& target = m_target.emplace();
+    target.color.fill<const uint8_t>(nullptr, m_width, m_height, 4);
+
+    target.fbo.bind(GL_DRAW_FRAMEBUFFER);
+    glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.color, 0);
+
+    if (glCheckFramebufferStatus(GL_DRAW_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("offscreen surface framebuffer is incomplete");
+    }
+
+    target.fbo.unbind();
+}
+
+
+backend::egl_context::~egl_context()
+{
+    m_target.reset();
+
+    eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+
+    if (m_surface != EGL_NO_SURFACE) {
+        eglDestroySurface(m_display, m_surface);
+    }
+
+    eglDestroyContext(m_display, m_context);
+    eglTerminate(m_display);
+}
+
+
+bool backend::egl_context::should_close() const
+{
+    return m_frames > 0 && m_presented >= m_frames;
+}
+
+
+std::pair<uint32_t, uint32_t> backend::egl_context::get_surface_size() const
+{
+    return {m_width, m_height};
+}
+
+
+uint32_t backend::egl_context::get_surface_framebuffer() const
+{
+    return m_target->fbo;
+}
+
+
+void backend::egl_context::present()
+{
+    // nothing throttles offscreen frames, the next one is not recorded before the gpu is done with this one.
+    glFinish();
+    ++m_presented;
+}
+
+
+uint32_t backend::egl_context::get_presented_count() const
+{
+    return m_presented;
+}
+
+
+EGLDisplay backend::egl_context::get_display()
+{
+    const bool client_extensions = has_egl_extension(EGL_NO_DISPLAY, "EGL_EXT_platform_base");
+
+    // mesa surfaceless platform needs neither a display server nor a gpu device.
+    if (client_extensions && has_egl_extension(EGL_NO_DISPLAY, "EGL_MESA_platform_surfaceless")) {
+        const auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+        if (get_platform_display != nullptr) {
+            if (const auto display = get_platform_display(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr); display != EGL_NO_DISPLAY) {
+                return display;
+            }
+        }
+    }
+
+    // first gpu device, e.g. a render node of a headless server.
+    if (client_extensions && has_egl_extension(EGL_NO_DISPLAY, "EGL_EXT_platform_device")) {
+        const auto query_devices = reinterpret_cast<PFNEGLQUERYDEVICESEXTPROC>(eglGetProcAddress("eglQueryDevicesEXT"));
+        const auto get_platform_display = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(eglGetProcAddress("eglGetPlatformDisplayEXT"));
+
+        EGLDeviceEXT device;
+        EGLint devices_count = 0;
+
+        if (query_devices != nullptr && get_platform_display != nullptr && query_devices(1, &device, &devices_count) && devices_count > 0) {
+            if (const auto display = get_platform_display(EGL_PLATFORM_DEVICE_EXT, device, nullptr); display != EGL_NO_DISPLAY) {
+                return display;
+            }
+        }
+    }
+
+    const auto display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+    if (display == EGL_NO_DISPLAY) {
+        throw std::runtime_error("no egl display");
+    }
+
+    return display;
+}
@@ -0,0 +1,54 @@
+
+
+#pragma once
+
+#include <backend/context.hpp>
+
+#include <gl/framebuffer_object.hpp>
+#include <gl/textures.hpp>
+
+#include <EGL/egl.h>
+
+#include <optional>
+
+namespace backend
+{
+    // headless 4.1 core context without a window system, e.g. on render nodes or with mesa llvmpipe.
+    // the context is surfaceless if the display supports it and has a pbuffer otherwise, frames are
+    // blitted to an offscreen rgba8 framebuffer of the surface size.
+    class egl_context : public context
+    {
+    public:
+        // frames is the number of frames to present before should_close, 0 never closes.
+        egl_context(uint32_t width, uint32_t height, uint32_t frames = 0);
+        ~egl_context() override;
+
+        bool should_close() const override;
+        std::pair<uint32_t, uint32_t> get_surface_size() const override;
+        uint32_t get_surface_framebuffer() const override;
+        void present() override;
+
+        uint32_t get_presented_count() const;
+
+    private:
+        static EGLDisplay get_display();
+
+        EGLDisplay m_display{EGL_NO_DISPLAY};
+        EGLContext m_context{EGL_NO_CONTEXT};
+        EGLSurface m_surface{EGL_NO_SURFACE};
+
+        uint32_t m_width;
+        uint32_t m_height;
+        uint32_t m_frames;
+        uint32_t m_presented{0};
+
+        // created after gl is loaded, destroyed before the context.
+        struct surface_target
+        {
+            gl::texture<GL_TEXTURE_2D> color;
+            gl::framebuffer_object fbo;
+        };
+
+        std::optional<surface_target> m_target;
+    };
+} // namespace backend
@@ -0,0 +1,71 @@
+
+
+#include "glfw_context.hpp"
+
+#include <stdexcept>
+
+
+backend::glfw_context::glfw_context(uint32_t width, uint32_t height, const char* title)
+{
+    if (!glfwInit()) {
+        throw std::runtime_error("failed to initialize glfw");
+    }
+
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#ifdef __APPLE__
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#endif
+    glfwWindowHint(GLFW_OPENGL_DEBUG_CONTEXT, gl::debug_build ? GL_TRUE : GL_FALSE);
+
+    m_window = glfwCreateWindow(width, height, title, nullptr, nullptr);
+
+    if (m_window == nullptr) {
+        glfwTerminate();
+        throw std::runtime_error("failed to create a window");
+    }
+
+    glfwMakeContextCurrent(m_window);
+    load_gl(reinterpret_cast<gl::proc_loader>(glfwGetProcAddress));
+}
+
+
+backend::glfw_context::~glfw_context()
+{
+    glfwDestroyWindow(m_window);
+    glfwTerminate();
+}
+
+
+bool backend::glfw_context::should_close() const
+{
+    return glfwWindowShouldClose(m_window);
+}
+
+
+std::pair<uint32_t, uint32_t> backend::glfw_context::get_surface_size() const
+{
+    int32_t width, height;
+    glfwGetFramebufferSize(m_window, &width, &height);
+    return {width, height};
+}
+
+
+uint32_t backend::glfw_context::get_surface_framebuffer() const
+{
+    return 0;
+}
+
+
+void backend::glfw_context::present()
+{
+    glfwSwapBuffers(m_window);
+    glfwPollEvents();
+}
+
+
+GLFWwindow* backend::glfw_context::get_window() const
+{
+    return m_window;
+}
@@ -0,0 +1,29 @@
+
+
+#pragma once
+
+#include <backend/context.hpp>
+
+#include <GLFW/glfw3.h>
+
+namespace backend
+{
+    // window with a 4.1 core context.
+    class glfw_context : public context
+    {
+    public:
+        glfw_context(uint32_t width, uint32_t height, const char* title);
+        ~glfw_context() override;
+
+        bool should_close() const override;
+        std::pair<uint32_t, uint32_t> get_surface_size() const override;
+        uint32_t get_surface_framebuffer() const override;
+        void present() override;
+
+        // input is read from the window directly.
+        GLFWwindow* get_window() const;
+
+    private:
+        GLFWwindow* m_window{nullptr};
+    };
+} // namespace backend
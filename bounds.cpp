@@ -0,0 +1,113 @@
+
+
+#include "bounds.hpp"
+
+#include <glm/glm.hpp>
+
+#include <cmath>
+
+
+bool utils::aabb::is_empty() const
+{
+    return min.x > max.x || min.y > max.y || min.z > max.z;
+}
+
+
+void utils::aabb::expand(const glm::vec3& point)
+{
+    min = glm::min(min, point);
+    max = glm::max(max, point);
+}
+
+
+void utils::aabb::expand(const utils::aabb& box)
+{
+    if (box.is_empty()) {
+        return;
+    }
+
+    min = glm::min(min, box.min);
+    max = glm::max(max, box.max);
+}
+
+
+glm::vec3 utils::aabb::get_center() const
+{
+    return (min + max) * 0.5f;
+}
+
+
+glm::vec3 utils::aabb::get_extents() const
+{
+    return (max - min) * 0.5f;
+}
+
+
+utils::aabb utils::transform_aabb(const glm::mat4& transform, const utils::aabb& box)
+{
+    if (box.is_empty()) {
+        return box;
+    }
+
+    // center is transformed as a point, extents by the absolute values of the linear part.
+    const auto center = glm::vec3(transform * glm::vec4(box.get_center(), 1));
+    const auto extents = box.get_extents();
+
+    glm::vec3 new_extents{0};
+
+    for (int32_t c = 0; c < 3; ++c) {
+        for (int32_t r = 0; r < 3; ++r) {
+            new_extents[r] += std::abs(transform[c][r]) * extents[c];
+        }
+    }
+
+    aabb res;
+    res.min = center - new_extents;
+    res.max = center + new_extents;
+
+    return res;
+}
+
+
+utils::frustum utils::make_frustum(const glm::mat4& view_projection)
+{
+    const auto row = [&view_projection](int32_t r) {
+        return glm::vec4(view_projection[0][r], view_projection[1][r], view_projection[2][r], view_projection[3][r]);
+    };
+
+    frustum res;
+    res.planes[0] = row(3) + row(0);
+    res.planes[1] = row(3) - row(0);
+    res.planes[2] = row(3) + row(1);
+    res.planes[3] = row(3) - row(1);
+    res.planes[4] = row(3) + row(2);
+    res.planes[5] = row(3) - row(2);
+
+    for (auto& plane : res.planes) {
+        plane /= glm::length(glm::vec3(plane));
+    }
+
+    return res;
+}
+
+
+bool utils::is_visible(const utils::frustum& frustum, const utils::aabb& box)
+{
+    if (box.is_empty()) {
+        return false;
+    }
+
+    const auto center = box.get_center();
+    const auto extents = box.get_extents();
+
+    for (const auto& plane : frustum.planes) {
+        const float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+        const float radius = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+
+        if (distance + radius < 0) {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,41 @@
+
+
+
+#pragma once
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <array>
+#include <limits>
+
+namespace utils
+{
+    struct aabb
+    {
+        glm::vec3 min{std::numeric_limits<float>::max()};
+        glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+        bool is_empty() const;
+        void expand(const glm::vec3& point);
+        void expand(const aabb& box);
+        glm::vec3 get_center() const;
+        glm::vec3 get_extents() const;
+    };
+
+    // aabb of the transformed box, empty boxes stay empty.
+    aabb transform_aabb(const glm::mat4& transform, const aabb& box);
+
+    struct frustum
+    {
+        // left, right, bottom, top, near, far. normals point inside.
+        std::array<glm::vec4, 6> planes;
+    };
+
+    // frustum of a view projection matrix, works for a camera or a light (shadow casters).
+    frustum make_frustum(const glm::mat4& view_projection);
+
+    // false only if the box is entirely outside one of the planes.
+    bool is_visible(const frustum& frustum, const aabb& box);
+} // namespace utils
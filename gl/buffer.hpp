@@ -65,6 +65,17 @@ namespace gl
             glBufferData(GlBufferType, data_size, data, usage);
         }
 
+        void update(const void* data, uint32_t data_size, uint32_t offset = 0) const
+        {
+            bind_guard guard(*this);
+            glBufferSubData(GlBufferType, offset, data_size, data);
+        }
+
+        operator uint32_t() const
+        {
+            return m_gl_handler;
+        }
+
     private:
         uint32_t m_gl_handler{0};
     };
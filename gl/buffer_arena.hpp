@@ -0,0 +1,104 @@
+
+
+
+#pragma once
+
+#include <gl/buffer.hpp>
+#include <gl/range_allocator.hpp>
+
+#include <cassert>
+#include <vector>
+
+namespace gl
+{
+    // few large buffers (pages) sub-allocated into regions, instead of a gl buffer per vertex attribute.
+    // a page is never resized or moved, so buffers and offsets of live regions stay valid.
+    template<uint32_t GlBufferType>
+    class buffer_arena
+    {
+    public:
+        struct region
+        {
+            uint32_t page = uint32_t(-1);
+            uint32_t offset = 0;
+            uint32_t size = 0;
+
+            bool is_valid() const
+            {
+                return page != uint32_t(-1);
+            }
+        };
+
+        explicit buffer_arena(uint32_t page_size = 32 * 1024 * 1024)
+            : m_page_size(page_size)
+        {
+        }
+
+        buffer_arena(const buffer_arena&) = delete;
+        buffer_arena& operator=(const buffer_arena&) = delete;
+
+        // regions larger than the page size get a dedicated page.
+        region allocate(uint32_t size, uint32_t alignment = 16)
+        {
+            for (uint32_t i = 0; i < m_pages.size(); ++i) {
+                if (auto r = m_pages[i].allocator.allocate(size, alignment)) {
+                    return region{i, uint32_t(r->offset), size};
+                }
+            }
+
+            auto& new_page = m_pages.emplace_back(std::max(m_page_size, size));
+
+            const auto r = new_page.allocator.allocate(size, alignment);
+            assert(r);
+
+            return region{uint32_t(m_pages.size() - 1), uint32_t(r->offset), size};
+        }
+
+        region allocate(const void* data, uint32_t size, uint32_t alignment = 16)
+        {
+            const auto r = allocate(size, alignment);
+            upload(r, data);
+            return r;
+        }
+
+        void upload(const region& r, const void* data, uint32_t size = 0, uint32_t offset = 0) const
+        {
+            size = size == 0 ? r.size : size;
+            assert(offset + size <= r.size);
+            m_pages.at(r.page).buf.update(data, size, r.offset + offset);
+        }
+
+        void free(const region& r)
+        {
+            if (r.is_valid()) {
+                m_pages.at(r.page).allocator.free({r.offset, r.size});
+            }
+        }
+
+        const buffer<GlBufferType>& get_buffer(const region& r) const
+        {
+            return m_pages.at(r.page).buf;
+        }
+
+        uint32_t get_pages_count() const
+        {
+            return m_pages.size();
+        }
+
+    private:
+        struct page
+        {
+            explicit page(uint32_t size)
+                : allocator(size)
+            {
+                buf.fill(nullptr, size);
+            }
+
+            buffer<GlBufferType> buf;
+            range_allocator allocator;
+        };
+
+        uint32_t m_page_size;
+        std::vector<page> m_pages;
+    };
+} // namespace gl
@@ -0,0 +1,139 @@
+
+
+#include "debug.hpp"
+
+#include <gl/extensions.hpp>
+
+#include <iostream>
+#include <stdexcept>
+
+namespace
+{
+    bool debug_output_enabled = false;
+
+    // first error reported by the callback since the last check, exceptions must not leave the driver's frames.
+    thread_local std::string pending_error;
+
+
+    const char* get_type_name(GLenum type)
+    {
+        switch (type) {
+            case GL_DEBUG_TYPE_ERROR:
+                return "error";
+            case GL_DEBUG_TYPE_DEPRECATED_BEHAVIOR:
+                return "deprecated";
+            case GL_DEBUG_TYPE_UNDEFINED_BEHAVIOR:
+                return "undefined behavior";
+            case GL_DEBUG_TYPE_PORTABILITY:
+                return "portability";
+            case GL_DEBUG_TYPE_PERFORMANCE:
+                return "performance";
+            default:
+                return "other";
+        }
+    }
+
+
+    void APIENTRY on_debug_message(GLenum, GLenum type, GLuint id, GLenum severity, GLsizei length, const GLchar* message, const void*)
+    {
+        if (type == GL_DEBUG_TYPE_PUSH_GROUP || type == GL_DEBUG_TYPE_POP_GROUP) {
+            return;
+        }
+
+        const std::string text(message, length >= 0 ? size_t(length) : std::char_traits<char>::length(message));
+
+        // output is synchronous, check_error on the same thread throws the first error.
+        if (type == GL_DEBUG_TYPE_ERROR || severity == GL_DEBUG_SEVERITY_HIGH) {
+            if (pending_error.empty()) {
+                pending_error = "gl " + std::string(get_type_name(type)) + " " + std::to_string(id) + ": " + text;
+            }
+            return;
+        }
+
+        std::cerr << "gl " << get_type_name(type) << " " << id << ": " << text << std::endl;
+    }
+
+
+    // a 4.1 context loads the KHR_debug entry points only as an extension.
+    template<typename Proc>
+    bool load_proc(Proc& proc, gl::proc_loader load, const char* name)
+    {
+        if (proc == nullptr) {
+            proc = reinterpret_cast<Proc>(load(name));
+        }
+
+        if (proc == nullptr) {
+            proc = reinterpret_cast<Proc>(load((std::string(name) + "KHR").c_str()));
+        }
+
+        return proc != nullptr;
+    }
+} // namespace
+
+
+bool gl::enable_debug_output(gl::proc_loader load)
+{
+    if constexpr (!debug_build) {
+        return false;
+    }
+
+    if (!has_extension("GL_KHR_debug")) {
+        return false;
+    }
+
+    const bool loaded = load_proc(glad_glDebugMessageCallback, load, "glDebugMessageCallback")
+        && load_proc(glad_glDebugMessageControl, load, "glDebugMessageControl")
+        && load_proc(glad_glPushDebugGroup, load, "glPushDebugGroup")
+        && load_proc(glad_glPopDebugGroup, load, "glPopDebugGroup");
+
+    if (!loaded) {
+        return false;
+    }
+
+    glEnable(GL_DEBUG_OUTPUT);
+    glEnable(GL_DEBUG_OUTPUT_SYNCHRONOUS);
+    glDebugMessageCallback(on_debug_message, nullptr);
+    glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, nullptr, GL_FALSE);
+
+    debug_output_enabled = true;
+    return true;
+}
+
+
+bool gl::is_debug_output_enabled()
+{
+    return debug_output_enabled;
+}
+
+
+void gl::check_error(const char* file, int line)
+{
+    if (debug_output_enabled) {
+        if (!pending_error.empty()) {
+            const auto error = std::move(pending_error);
+            pending_error.clear();
+            throw std::runtime_error(std::string(file) + ":" + std::to_string(line) + " " + error);
+        }
+        return;
+    }
+
+    if (const auto error = glGetError(); error != GL_NO_ERROR) {
+        throw std::runtime_error(std::string(file) + ":" + std::to_string(line) + " gl error " + std::to_string(error));
+    }
+}
+
+
+void gl::push_debug_group(const std::string& label)
+{
+    if (debug_output_enabled) {
+        glPushDebugGroup(GL_DEBUG_SOURCE_APPLICATION, 0, label.size(), label.c_str());
+    }
+}
+
+
+void gl::pop_debug_group()
+{
+    if (debug_output_enabled) {
+        glPopDebugGroup();
+    }
+}
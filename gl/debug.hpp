@@ -0,0 +1,61 @@
+
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+
+namespace gl
+{
+    // error checks, debug output and debug groups exist in debug builds only, release builds do not poll gl errors.
+#ifdef NDEBUG
+    inline constexpr bool debug_build = false;
+#else
+    inline constexpr bool debug_build = true;
+#endif
+
+    using proc_loader = void* (*) (const char* name);
+
+    // installs a KHR_debug message callback with synchronous output, the callback records the first error
+    // or high severity message and GL_CHECK_ERRORS throws it. returns false in release builds or without KHR_debug,
+    // GL_CHECK_ERRORS polls glGetError then.
+    bool enable_debug_output(proc_loader load);
+    bool is_debug_output_enabled();
+
+    // throws the error recorded by the debug callback, or polls glGetError when debug output is disabled.
+    // called through GL_CHECK_ERRORS.
+    void check_error(const char* file, int line);
+
+    void push_debug_group(const std::string& label);
+    void pop_debug_group();
+
+    // debug group of a scope.
+    class debug_group
+    {
+    public:
+        explicit debug_group(const std::string& label)
+        {
+            if constexpr (debug_build) {
+                push_debug_group(label);
+            }
+        }
+
+        ~debug_group()
+        {
+            if constexpr (debug_build) {
+                pop_debug_group();
+            }
+        }
+
+        debug_group(const debug_group&) = delete;
+        debug_group& operator=(const debug_group&) = delete;
+    };
+} // namespace gl
+
+// error checks of debug builds without debug output, nothing in release builds.
+#ifdef NDEBUG
+    #define GL_CHECK_ERRORS() static_cast<void>(0)
+#else
+    #define GL_CHECK_ERRORS() ::gl::check_error(__FILE__, __LINE__)
+#endif
@@ -0,0 +1,26 @@
+
+
+#include "extensions.hpp"
+
+#include <unordered_set>
+
+
+bool gl::has_extension(const std::string& name)
+{
+    static const auto extensions = [] {
+        std::unordered_set<std::string> result;
+
+        int32_t count = 0;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &count);
+
+        for (int32_t i = 0; i < count; ++i) {
+            if (const auto ext = reinterpret_cast<const char*>(glGetStringi(GL_EXTENSIONS, i)); ext != nullptr) {
+                result.emplace(ext);
+            }
+        }
+
+        return result;
+    }();
+
+    return extensions.find(name) != extensions.end();
+}
@@ -0,0 +1,18 @@
+
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <string>
+
+// enums of extensions the loader was not generated with.
+#ifndef GL_COMPLETION_STATUS_KHR
+    #define GL_COMPLETION_STATUS_KHR 0x91B1
+#endif
+
+namespace gl
+{
+    // extensions of the current context, queried once. a context must be current.
+    bool has_extension(const std::string& name);
+} // namespace gl
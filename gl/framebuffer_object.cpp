@@ -51,7 +51,7 @@ void gl::framebuffer_object::unbind()
 
 
 void gl::framebuffer_object::blit(
-    uint32_t dst_handler, uint32_t from_width, uint32_t from_height, uint32_t dst_width, uint32_t dst_height)
+    uint32_t dst_handler, uint32_t from_width, uint32_t from_height, uint32_t dst_width, uint32_t dst_height, GLenum filter)
 {
     int32_t read_fb, draw_fb;
 
@@ -61,7 +61,7 @@ void gl::framebuffer_object::blit(
     {
         glBindFramebuffer(GL_READ_FRAMEBUFFER, m_gl_handler);
         glBindFramebuffer(GL_DRAW_FRAMEBUFFER, dst_handler);
-        glBlitFramebuffer(0, 0, from_width, from_height, 0, 0, dst_width, dst_height, GL_COLOR_BUFFER_BIT, GL_LINEAR);
+        glBlitFramebuffer(0, 0, from_width, from_height, 0, 0, dst_width, dst_height, GL_COLOR_BUFFER_BIT, filter);
     }
 
     glBindFramebuffer(GL_READ_FRAMEBUFFER, read_fb);
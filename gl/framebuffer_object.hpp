@@ -23,7 +23,7 @@ namespace gl
 
         operator uint32_t() const;
 
-        void blit(uint32_t dst_handler, uint32_t from_width, uint32_t from_height, uint32_t dst_width, uint32_t dst_height);
+        void blit(uint32_t dst_handler, uint32_t from_width, uint32_t from_height, uint32_t dst_width, uint32_t dst_height, GLenum filter = GL_LINEAR);
 
     private:
         uint32_t m_gl_handler;
@@ -0,0 +1,76 @@
+
+
+#include "gpu_timer.hpp"
+
+#include <cassert>
+
+
+gl::gpu_timer::gpu_timer(uint32_t latency)
+    : m_queries(latency, 0)
+{
+    assert(latency > 0);
+}
+
+
+gl::gpu_timer::~gpu_timer()
+{
+    if (m_queries.front() != 0) {
+        glDeleteQueries(m_queries.size(), m_queries.data());
+    }
+}
+
+
+void gl::gpu_timer::begin()
+{
+    assert(!m_active);
+
+    if (m_queries.front() == 0) {
+        glGenQueries(m_queries.size(), m_queries.data());
+    }
+
+    if (m_pending == m_queries.size()) {
+        return;
+    }
+
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[m_next]);
+    m_active = true;
+}
+
+
+void gl::gpu_timer::end()
+{
+    if (!m_active) {
+        return;
+    }
+
+    glEndQuery(GL_TIME_ELAPSED);
+    m_active = false;
+    m_next = (m_next + 1) % m_queries.size();
+    ++m_pending;
+}
+
+
+bool gl::gpu_timer::poll(double& milliseconds)
+{
+    bool has_result = false;
+
+    while (m_pending > 0) {
+        const auto oldest = m_queries[(m_next + m_queries.size() - m_pending) % m_queries.size()];
+
+        int32_t available = 0;
+        glGetQueryObjectiv(oldest, GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (!available) {
+            break;
+        }
+
+        uint64_t nanoseconds = 0;
+        glGetQueryObjectui64v(oldest, GL_QUERY_RESULT, &nanoseconds);
+
+        milliseconds = double(nanoseconds) / 1e6;
+        has_result = true;
+        --m_pending;
+    }
+
+    return has_result;
+}
@@ -0,0 +1,35 @@
+
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cinttypes>
+#include <vector>
+
+namespace gl
+{
+    // GL_TIME_ELAPSED queries in a ring, results are read frames later when they are available,
+    // so measuring never stalls the cpu on the gpu. a begin with every query in flight is not measured.
+    class gpu_timer
+    {
+    public:
+        explicit gpu_timer(uint32_t latency = 4);
+        ~gpu_timer();
+
+        gpu_timer(const gpu_timer&) = delete;
+        gpu_timer& operator=(const gpu_timer&) = delete;
+
+        void begin();
+        void end();
+
+        // reads finished queries, returns true and the newest result if there was one.
+        bool poll(double& milliseconds);
+
+    private:
+        std::vector<uint32_t> m_queries;
+        uint32_t m_next{0};
+        uint32_t m_pending{0};
+        bool m_active{false};
+    };
+} // namespace gl
@@ -0,0 +1,376 @@
+
+
+#include "profiler.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+
+namespace
+{
+    struct open_zone
+    {
+        uint32_t zone;
+        double begin_us;
+    };
+
+    std::atomic<uint32_t> threads_count{0};
+
+    // trace thread ids, the render thread is the first one to record a zone.
+    uint32_t get_thread_id()
+    {
+        thread_local const uint32_t id = threads_count++;
+        return id;
+    }
+
+
+    std::vector<open_zone>& get_cpu_stack()
+    {
+        thread_local std::vector<open_zone> stack;
+        return stack;
+    }
+
+
+    double get_percentile(const std::vector<float>& sorted, double p)
+    {
+        const auto rank = size_t(std::ceil(p * sorted.size()));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    }
+
+
+    void write_escaped(std::ofstream& file, const std::string& s)
+    {
+        file << '"';
+
+        for (const auto c : s) {
+            switch (c) {
+                case '"':
+                    file << "\\\"";
+                    break;
+                case '\\':
+                    file << "\\\\";
+                    break;
+                default:
+                    if (uint8_t(c) < 0x20) {
+                        file << ' ';
+                    } else {
+                        file << c;
+                    }
+                    break;
+            }
+        }
+
+        file << '"';
+    }
+} // namespace
+
+
+std::atomic<gl::profiler*> gl::profiler::s_current{nullptr};
+
+
+gl::profiler::profiler(uint32_t latency, uint32_t window)
+    : m_window(window)
+    , m_frames(latency)
+{
+    assert(latency > 0 && window > 0);
+}
+
+
+gl::profiler::~profiler()
+{
+    assert(get_current() != this);
+
+    for (auto& frame : m_frames) {
+        if (!frame.queries.empty()) {
+            glDeleteQueries(frame.queries.size(), frame.queries.data());
+        }
+    }
+}
+
+
+void gl::profiler::set_current(gl::profiler* p)
+{
+    s_current = p;
+}
+
+
+gl::profiler* gl::profiler::get_current()
+{
+    return s_current;
+}
+
+
+void gl::profiler::begin_frame()
+{
+    assert(m_active_frame == nullptr);
+
+    auto& frame = m_frames[m_frame % m_frames.size()];
+
+    if (frame.pending && !read_frame(frame)) {
+        ++m_skipped_frames;
+        return;
+    }
+
+    // gpu timestamps are mapped to the cpu timeline once a frame, so the clocks do not drift apart in a long trace.
+    int64_t gpu_ns = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpu_ns);
+    frame.gpu_base_us = get_time_us() - double(gpu_ns) / 1e3;
+
+    frame.used_queries = 0;
+    frame.records.clear();
+    m_active_frame = &frame;
+}
+
+
+void gl::profiler::end_frame()
+{
+    if (m_active_frame != nullptr) {
+        assert(m_gpu_stack.empty());
+        m_active_frame->pending = !m_active_frame->records.empty();
+        m_active_frame = nullptr;
+        ++m_frame;
+    }
+
+    // frames finish in order, the oldest one not finished ends the reading.
+    for (uint32_t i = 0; i < m_frames.size(); ++i) {
+        auto& frame = m_frames[(m_frame + i) % m_frames.size()];
+
+        if (frame.pending && !read_frame(frame)) {
+            break;
+        }
+    }
+}
+
+
+void gl::profiler::flush()
+{
+    assert(m_active_frame == nullptr);
+
+    for (uint32_t i = 0; i < m_frames.size(); ++i) {
+        auto& frame = m_frames[(m_frame + i) % m_frames.size()];
+
+        if (frame.pending) {
+            read_frame(frame, true);
+        }
+    }
+}
+
+
+void gl::profiler::begin_cpu_zone(const char* name)
+{
+    uint32_t zone_idx;
+
+    {
+        std::lock_guard lock(m_mutex);
+        const auto [it, inserted] = m_cpu_zones.emplace(name, uint32_t(m_zones.size()));
+
+        if (inserted) {
+            m_zones.emplace_back(zone{name, timeline::cpu});
+        }
+
+        zone_idx = it->second;
+    }
+
+    get_cpu_stack().emplace_back(open_zone{zone_idx, get_time_us()});
+}
+
+
+void gl::profiler::end_cpu_zone()
+{
+    auto& stack = get_cpu_stack();
+    assert(!stack.empty());
+
+    const auto [zone_idx, begin_us] = stack.back();
+    stack.pop_back();
+
+    std::lock_guard lock(m_mutex);
+    add_sample(zone_idx, get_thread_id(), begin_us, get_time_us() - begin_us);
+}
+
+
+void gl::profiler::begin_gpu_zone(const std::string& name)
+{
+    if (m_active_frame == nullptr) {
+        return;
+    }
+
+    auto& frame = *m_active_frame;
+
+    // query names are kept with the frame slot and reused every time the slot is measured.
+    if (frame.used_queries + 2 > frame.queries.size()) {
+        const auto first = frame.queries.size();
+        frame.queries.resize(std::max<size_t>(64, first * 2));
+        glGenQueries(frame.queries.size() - first, frame.queries.data() + first);
+    }
+
+    const auto query = frame.used_queries++;
+    glQueryCounter(frame.queries[query], GL_TIMESTAMP);
+
+    m_gpu_stack.emplace_back(frame.records.size());
+    frame.records.emplace_back(gpu_record{get_gpu_zone(name), query, query});
+}
+
+
+void gl::profiler::end_gpu_zone()
+{
+    if (m_active_frame == nullptr) {
+        return;
+    }
+
+    assert(!m_gpu_stack.empty());
+    auto& frame = *m_active_frame;
+
+    const auto query = frame.used_queries++;
+    glQueryCounter(frame.queries[query], GL_TIMESTAMP);
+
+    frame.records[m_gpu_stack.back()].end_query = query;
+    m_gpu_stack.pop_back();
+}
+
+
+void gl::profiler::set_draw_zones(bool draw_zones)
+{
+    m_draw_zones = draw_zones;
+}
+
+
+bool gl::profiler::has_draw_zones() const
+{
+    return m_draw_zones;
+}
+
+
+std::vector<gl::profiler::zone_stats> gl::profiler::get_stats() const
+{
+    std::vector<zone_stats> stats;
+    std::vector<float> sorted;
+
+    std::lock_guard lock(m_mutex);
+
+    for (const auto& z : m_zones) {
+        if (z.samples.empty()) {
+            continue;
+        }
+
+        sorted = z.samples;
+        std::sort(sorted.begin(), sorted.end());
+
+        stats.emplace_back(zone_stats{
+            z.name,
+            z.line,
+            uint32_t(sorted.size()),
+            get_percentile(sorted, 0.5),
+            get_percentile(sorted, 0.95),
+            get_percentile(sorted, 0.99)});
+    }
+
+    return stats;
+}
+
+
+void gl::profiler::write_trace(const std::string& path) const
+{
+    std::ofstream file(path, std::ios::trunc);
+
+    if (!file) {
+        throw std::runtime_error("failed to write " + path);
+    }
+
+    std::lock_guard lock(m_mutex);
+
+    // cpu and gpu are two processes of the trace, cpu threads are its threads.
+    file << "{\"traceEvents\":[\n"
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":{\"name\":\"cpu\"}},\n"
+         << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"gpu\"}}";
+
+    file.precision(3);
+    file << std::fixed;
+
+    for (const auto& e : m_events) {
+        const auto& z = m_zones[e.zone];
+
+        file << ",\n{\"name\":";
+        write_escaped(file, z.name);
+        file << ",\"cat\":\"" << (z.line == timeline::cpu ? "cpu" : "gpu") << "\",\"ph\":\"X\""
+             << ",\"ts\":" << e.begin_us << ",\"dur\":" << e.duration_us
+             << ",\"pid\":" << uint32_t(z.line) << ",\"tid\":" << e.thread << "}";
+    }
+
+    file << "\n],\"otherData\":{\"dropped_events\":" << m_dropped_events << ",\"skipped_frames\":" << m_skipped_frames << "}}\n";
+}
+
+
+uint32_t gl::profiler::get_gpu_zone(const std::string& name)
+{
+    std::lock_guard lock(m_mutex);
+
+    if (const auto it = m_gpu_zones.find(name); it != m_gpu_zones.end()) {
+        return it->second;
+    }
+
+    m_zones.emplace_back(zone{name, timeline::gpu});
+    m_gpu_zones.emplace(name, m_zones.size() - 1);
+
+    return m_zones.size() - 1;
+}
+
+
+void gl::profiler::add_sample(uint32_t zone_idx, uint32_t thread, double begin_us, double duration_us)
+{
+    auto& z = m_zones[zone_idx];
+
+    if (z.samples.size() < m_window) {
+        z.samples.emplace_back(float(duration_us / 1e3));
+    } else {
+        z.samples[z.next] = float(duration_us / 1e3);
+        z.next = (z.next + 1) % m_window;
+    }
+
+    if (m_events.size() < max_events) {
+        m_events.emplace_back(event{zone_idx, thread, begin_us, duration_us});
+    } else {
+        ++m_dropped_events;
+    }
+}
+
+
+double gl::profiler::get_time_us() const
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - m_start).count();
+}
+
+
+bool gl::profiler::read_frame(gl::profiler::gpu_frame& frame, bool wait)
+{
+    assert(frame.pending && frame.used_queries > 0);
+
+    // timestamps are written in order, the last one being available means all of them are.
+    // reading GL_QUERY_RESULT below blocks until it is when waiting.
+    if (!wait) {
+        int32_t available = 0;
+        glGetQueryObjectiv(frame.queries[frame.used_queries - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+        if (!available) {
+            return false;
+        }
+    }
+
+    std::vector<uint64_t> timestamps(frame.used_queries);
+
+    for (uint32_t i = 0; i < frame.used_queries; ++i) {
+        glGetQueryObjectui64v(frame.queries[i], GL_QUERY_RESULT, &timestamps[i]);
+    }
+
+    std::lock_guard lock(m_mutex);
+
+    for (const auto& record : frame.records) {
+        const auto begin_ns = timestamps[record.begin_query];
+        const auto end_ns = std::max(timestamps[record.end_query], begin_ns);
+        add_sample(record.zone, 0, frame.gpu_base_us + double(begin_ns) / 1e3, double(end_ns - begin_ns) / 1e3);
+    }
+
+    frame.pending = false;
+    return true;
+}
@@ -0,0 +1,165 @@
+
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gl
+{
+    // cpu zones of any thread and gpu zones of the render thread, exported as chrome trace events
+    // and summarized as percentiles of the last samples of every zone.
+    // gpu zones are GL_TIMESTAMP query pairs in a ring of frames, a frame is read latency frames later
+    // when its queries are available, so profiling never waits for the gpu. timestamps nest unlike
+    // elapsed queries, passes have draw zones in them and the frame may be in an elapsed query itself.
+    class profiler
+    {
+    public:
+        enum class timeline : uint32_t
+        {
+            cpu,
+            gpu
+        };
+
+        struct zone_stats
+        {
+            std::string name;
+            timeline line;
+            uint32_t samples;
+            double p50_ms;
+            double p95_ms;
+            double p99_ms;
+        };
+
+        // window is the number of last samples of a zone its percentiles are computed from.
+        explicit profiler(uint32_t latency = 4, uint32_t window = 256);
+        ~profiler();
+
+        profiler(const profiler&) = delete;
+        profiler& operator=(const profiler&) = delete;
+
+        // zones of all threads go to the current profiler, nothing is measured without one.
+        static void set_current(profiler*);
+        static profiler* get_current();
+
+        // gpu zones are measured between begin_frame and end_frame, a frame with every slot
+        // of the ring in flight is not measured.
+        void begin_frame();
+        // reads the gpu zones of finished frames.
+        void end_frame();
+        // waits for the gpu zones of the frames in flight, call before reading stats or writing a trace.
+        void flush();
+
+        // name has to live as long as the profiler, e.g. a literal.
+        void begin_cpu_zone(const char* name);
+        void end_cpu_zone();
+        // render thread only.
+        void begin_gpu_zone(const std::string& name);
+        void end_gpu_zone();
+
+        // draws get gpu zones too, a query pair per draw.
+        void set_draw_zones(bool);
+        bool has_draw_zones() const;
+
+        std::vector<zone_stats> get_stats() const;
+        // chrome://tracing or ui.perfetto.dev json of the recorded events.
+        void write_trace(const std::string& path) const;
+
+    private:
+        struct zone
+        {
+            std::string name;
+            timeline line;
+            std::vector<float> samples{};
+            uint32_t next{0};
+        };
+
+        struct event
+        {
+            uint32_t zone;
+            uint32_t thread;
+            double begin_us;
+            double duration_us;
+        };
+
+        struct gpu_record
+        {
+            uint32_t zone;
+            uint32_t begin_query;
+            uint32_t end_query;
+        };
+
+        struct gpu_frame
+        {
+            std::vector<uint32_t> queries;
+            uint32_t used_queries{0};
+            std::vector<gpu_record> records;
+            // cpu time of the gpu timestamp 0.
+            double gpu_base_us{0};
+            bool pending{false};
+        };
+
+        // events past it are dropped, a long run does not grow without bound.
+        static constexpr size_t max_events = 1 << 20;
+
+        uint32_t get_gpu_zone(const std::string& name);
+        // called with the mutex locked.
+        void add_sample(uint32_t zone_idx, uint32_t thread, double begin_us, double duration_us);
+        double get_time_us() const;
+        bool read_frame(gpu_frame& frame, bool wait = false);
+
+        static std::atomic<profiler*> s_current;
+
+        const uint32_t m_window;
+        const std::chrono::steady_clock::time_point m_start{std::chrono::steady_clock::now()};
+
+        mutable std::mutex m_mutex;
+        std::vector<zone> m_zones;
+        std::unordered_map<const char*, uint32_t> m_cpu_zones;
+        std::unordered_map<std::string, uint32_t> m_gpu_zones;
+        std::vector<event> m_events;
+        size_t m_dropped_events{0};
+        // frames begun with their ring slot still in flight, their gpu zones are not measured.
+        size_t m_skipped_frames{0};
+
+        std::vector<gpu_frame> m_frames;
+        uint32_t m_frame{0};
+        gpu_frame* m_active_frame{nullptr};
+        std::vector<uint32_t> m_gpu_stack;
+        bool m_draw_zones{false};
+    };
+
+
+    // cpu zone of a scope.
+    class cpu_zone
+    {
+    public:
+        explicit cpu_zone(const char* name)
+            : m_profiler(profiler::get_current())
+        {
+            if (m_profiler != nullptr) {
+                m_profiler->begin_cpu_zone(name);
+            }
+        }
+
+        ~cpu_zone()
+        {
+            if (m_profiler != nullptr) {
+                m_profiler->end_cpu_zone();
+            }
+        }
+
+        cpu_zone(const cpu_zone&) = delete;
+        cpu_zone& operator=(const cpu_zone&) = delete;
+
+    private:
+        profiler* m_profiler;
+    };
+} // namespace gl
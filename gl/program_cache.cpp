@@ -0,0 +1,353 @@
+
+
+#include "program_cache.hpp"
+
+#include <gl/extensions.hpp>
+
+#include <cassert>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+
+namespace
+{
+    constexpr uint32_t binary_magic = 0x42505347; // "GSPB"
+    constexpr uint32_t binary_version = 1;
+
+
+    void hash_bytes(uint64_t& h, const std::string& s)
+    {
+        // fnv-1a, the hash names files so it has to be the same in every run.
+        for (const auto c : s) {
+            h ^= uint8_t(c);
+            h *= 0x100000001b3ull;
+        }
+
+        // separates the stages, so moving text between them changes the hash.
+        h ^= 0xff;
+        h *= 0x100000001b3ull;
+    }
+
+
+    template<typename T>
+    void write(std::ofstream& file, const T& value)
+    {
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    }
+
+
+    template<typename T>
+    bool read(std::ifstream& file, T& value)
+    {
+        return bool(file.read(reinterpret_cast<char*>(&value), sizeof(value)));
+    }
+} // namespace
+
+
+std::string gl::add_defines(const std::string& source, const std::vector<std::string>& defines)
+{
+    const auto version_end = source.find('\n') + 1;
+    std::string result = source.substr(0, version_end);
+
+    for (const auto& define : defines) {
+        result += "#define " + define + "\n";
+    }
+
+    return result + source.substr(version_end);
+}
+
+
+void gl::program_cache::set_directory(std::string directory)
+{
+    m_directory = std::move(directory);
+
+    if (!m_directory.empty()) {
+        std::error_code error;
+        std::filesystem::create_directories(m_directory, error);
+
+        if (error) {
+            std::cerr << "program cache directory " << m_directory << " is not available, " << error.message() << std::endl;
+            m_directory.clear();
+        }
+    }
+}
+
+
+uint32_t gl::program_cache::get_program(std::vector<gl::program>& programs, const gl::program_sources& sources, int32_t fallback)
+{
+    const auto key = hash(sources);
+
+    if (const auto it = m_programs.find(key); it != m_programs.end()) {
+        ++m_reused;
+        return it->second;
+    }
+
+    assert(fallback < int32_t(programs.size()));
+
+    programs.emplace_back();
+    const uint32_t index = programs.size() - 1;
+
+    m_programs.emplace(key, index);
+    m_pending.emplace(index, pending_program{key, sources, fallback});
+
+    return index;
+}
+
+
+uint32_t gl::program_cache::use(std::vector<gl::program>& programs, uint32_t index)
+{
+    const auto it = m_pending.find(index);
+
+    if (it == m_pending.end()) {
+        return index;
+    }
+
+    auto& pending = it->second;
+
+    if (!pending.building) {
+        if (auto loaded = load_binary(pending.key)) {
+            programs.at(index) = std::move(*loaded);
+            ++m_loaded;
+            m_pending.erase(it);
+            return index;
+        }
+
+        programs.at(index) = program{pending.sources};
+        pending.building = true;
+    }
+
+    if (pending.fallback < 0) {
+        finish(programs, it);
+        return index;
+    }
+
+    return use(programs, pending.fallback);
+}
+
+
+uint32_t gl::program_cache::get_draw_program(uint32_t index) const
+{
+    const auto it = m_pending.find(index);
+
+    if (it == m_pending.end()) {
+        return index;
+    }
+
+    assert(it->second.building && it->second.fallback >= 0);
+    return get_draw_program(it->second.fallback);
+}
+
+
+bool gl::program_cache::poll(std::vector<gl::program>& programs)
+{
+    const bool parallel_compile = has_extension("GL_KHR_parallel_shader_compile");
+    bool finished = false;
+
+    for (auto it = m_pending.begin(); it != m_pending.end();) {
+        auto& pending = it->second;
+
+        if (!pending.building) {
+            ++it;
+            continue;
+        }
+
+        ++pending.polls;
+
+        if ((parallel_compile || pending.polls > deferred_status_polls) && programs.at(it->first).is_ready()) {
+            it = finish(programs, it);
+            finished = true;
+        } else {
+            ++it;
+        }
+    }
+
+    return finished;
+}
+
+
+bool gl::program_cache::is_linked(uint32_t index) const
+{
+    return m_pending.find(index) == m_pending.end();
+}
+
+
+uint32_t gl::program_cache::get_version() const
+{
+    return m_version;
+}
+
+
+uint32_t gl::program_cache::get_compiled_count() const
+{
+    return m_compiled;
+}
+
+
+uint32_t gl::program_cache::get_loaded_count() const
+{
+    return m_loaded;
+}
+
+
+uint32_t gl::program_cache::get_reused_count() const
+{
+    return m_reused;
+}
+
+
+uint64_t gl::program_cache::hash(const gl::program_sources& sources)
+{
+    uint64_t h = 0xcbf29ce484222325ull;
+
+    hash_bytes(h, sources.vs);
+    hash_bytes(h, sources.fs);
+    hash_bytes(h, sources.gs);
+
+    return h;
+}
+
+
+gl::program_cache::pending_iterator gl::program_cache::finish(std::vector<gl::program>& programs, gl::program_cache::pending_iterator it)
+{
+    auto& p = programs.at(it->first);
+    p.finish();
+
+    ++m_compiled;
+    ++m_version;
+
+    if (!m_directory.empty()) {
+        store(it->second.key, p);
+    }
+
+    return m_pending.erase(it);
+}
+
+
+std::optional<gl::program> gl::program_cache::load_binary(uint64_t key) const
+{
+    if (m_directory.empty()) {
+        return std::nullopt;
+    }
+
+    try {
+        return load(key);
+    } catch (const std::runtime_error&) {
+        // the driver rejected the binary, it is compiled and stored again.
+        return std::nullopt;
+    }
+}
+
+
+std::optional<gl::program> gl::program_cache::load(uint64_t key) const
+{
+    std::ifstream file(get_path(key), std::ios::binary);
+
+    if (!file) {
+        return std::nullopt;
+    }
+
+    uint32_t magic = 0, version = 0, driver_length = 0, binary_format = 0;
+    uint64_t stored_key = 0, binary_length = 0;
+
+    if (!read(file, magic) || magic != binary_magic || !read(file, version) || version != binary_version) {
+        return std::nullopt;
+    }
+
+    if (!read(file, stored_key) || stored_key != key || !read(file, driver_length)) {
+        return std::nullopt;
+    }
+
+    std::string driver(driver_length, '\0');
+
+    if (!file.read(driver.data(), driver_length) || driver != get_driver()) {
+        return std::nullopt;
+    }
+
+    if (!read(file, binary_format) || !read(file, binary_length)) {
+        return std::nullopt;
+    }
+
+    // a truncated or corrupt file is a miss, its length is not allocated.
+    const auto binary_offset = file.tellg();
+    file.seekg(0, std::ios::end);
+    const auto remaining = uint64_t(file.tellg() - binary_offset);
+    file.seekg(binary_offset);
+
+    if (!file || binary_length == 0 || binary_length != remaining) {
+        return std::nullopt;
+    }
+
+    std::vector<uint8_t> binary(binary_length);
+
+    if (!file.read(reinterpret_cast<char*>(binary.data()), binary_length)) {
+        return std::nullopt;
+    }
+
+    return std::make_optional<program>(binary_format, binary);
+}
+
+
+void gl::program_cache::store(uint64_t key, const gl::program& p) const
+{
+    uint32_t binary_format = 0;
+    const auto binary = p.get_binary(binary_format);
+
+    // e.g. drivers without program binary formats.
+    if (binary.empty()) {
+        return;
+    }
+
+    // written aside and renamed, so a file being written is never read by another run.
+    const auto path = get_path(key);
+    const auto tmp_path = path + ".tmp";
+
+    {
+        std::ofstream file(tmp_path, std::ios::binary | std::ios::trunc);
+
+        if (!file) {
+            return;
+        }
+
+        const auto& driver = get_driver();
+
+        write(file, binary_magic);
+        write(file, binary_version);
+        write(file, key);
+        write(file, uint32_t(driver.size()));
+        file.write(driver.data(), driver.size());
+        write(file, binary_format);
+        write(file, uint64_t(binary.size()));
+        file.write(reinterpret_cast<const char*>(binary.data()), binary.size());
+
+        if (!file) {
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tmp_path, path, error);
+}
+
+
+std::string gl::program_cache::get_path(uint64_t key) const
+{
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_directory) / name).string();
+}
+
+
+const std::string& gl::program_cache::get_driver() const
+{
+    if (m_driver.empty()) {
+        for (const auto name : {GL_VENDOR, GL_RENDERER, GL_VERSION}) {
+            const auto str = reinterpret_cast<const char*>(glGetString(name));
+            m_driver += str != nullptr ? str : "";
+            m_driver += '\n';
+        }
+    }
+
+    return m_driver;
+}
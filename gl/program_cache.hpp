@@ -0,0 +1,86 @@
+
+
+#pragma once
+
+#include <gl/shaders.hpp>
+
+#include <cinttypes>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace gl
+{
+    // copy of source with a #define of every define after its #version line.
+    std::string add_defines(const std::string& source, const std::vector<std::string>& defines);
+
+    // links every set of sources once, on the first use of the program. programs are looked up by a hash
+    // of the sources, defines included, and their binaries are kept in a directory, so the next run links
+    // them without compiling glsl. files of another driver vendor, renderer or version are ignored and rewritten.
+    // a program with a fallback is built in the background, the fallback is drawn with until poll finishes it.
+    class program_cache
+    {
+    public:
+        program_cache() = default;
+        ~program_cache() = default;
+
+        // empty directory keeps programs only in memory. created if it does not exist.
+        void set_directory(std::string directory);
+
+        // index of the program of the sources in programs. a new program is appended to them empty
+        // and linked on its first use, so variants which are never drawn are never compiled.
+        // fallback is the index of a program without one, e.g. a cheaper variant.
+        uint32_t get_program(std::vector<program>& programs, const program_sources& sources, int32_t fallback = -1);
+        // starts linking the program at index if it is not linked yet, returns the index to draw with:
+        // the program or its fallback while it is being built. a program without fallback is linked before return.
+        uint32_t use(std::vector<program>& programs, uint32_t index);
+        // index use returned last, does not change the cache so it may be called from recording threads.
+        uint32_t get_draw_program(uint32_t index) const;
+        // finishes the builds the driver is done with, never waits for it. returns true if any was finished.
+        bool poll(std::vector<program>& programs);
+        bool is_linked(uint32_t index) const;
+        // changes when a build is finished, draws recorded with fallbacks have to be recorded again.
+        uint32_t get_version() const;
+
+        uint32_t get_compiled_count() const;
+        uint32_t get_loaded_count() const;
+        uint32_t get_reused_count() const;
+
+        static uint64_t hash(const program_sources& sources);
+
+    private:
+        struct pending_program
+        {
+            uint64_t key;
+            program_sources sources;
+            int32_t fallback;
+            bool building{false};
+            uint32_t polls{0};
+        };
+
+        // without KHR_parallel_shader_compile statuses are queried this many polls after the build starts,
+        // drivers compiling on their own threads are likely done by then.
+        static constexpr uint32_t deferred_status_polls = 2;
+
+        using pending_iterator = std::unordered_map<uint32_t, pending_program>::iterator;
+
+        pending_iterator finish(std::vector<program>& programs, pending_iterator it);
+        std::optional<program> load_binary(uint64_t key) const;
+        std::optional<program> load(uint64_t key) const;
+        void store(uint64_t key, const program& p) const;
+        std::string get_path(uint64_t key) const;
+        const std::string& get_driver() const;
+
+        std::string m_directory;
+        mutable std::string m_driver;
+        std::unordered_map<uint64_t, uint32_t> m_programs;
+        // programs which are not linked yet by their indices.
+        std::unordered_map<uint32_t, pending_program> m_pending;
+        uint32_t m_version{0};
+
+        uint32_t m_compiled{0};
+        uint32_t m_loaded{0};
+        uint32_t m_reused{0};
+    };
+} // namespace gl
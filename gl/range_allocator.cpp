@@ -0,0 +1,125 @@
+
+
+#include "range_allocator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <iterator>
+
+
+gl::range_allocator::range_allocator(uint64_t capacity)
+    : m_capacity(capacity)
+{
+    reset();
+}
+
+
+std::optional<gl::range_allocator::range> gl::range_allocator::allocate(uint64_t size, uint64_t alignment)
+{
+    assert(alignment > 0);
+
+    if (size == 0) {
+        return std::nullopt;
+    }
+
+    for (auto it = m_free_ranges.begin(); it != m_free_ranges.end(); ++it) {
+        const auto [free_offset, free_size] = *it;
+        const auto offset = (free_offset + alignment - 1) / alignment * alignment;
+        const auto padding = offset - free_offset;
+
+        if (free_size < padding + size) {
+            continue;
+        }
+
+        m_free_ranges.erase(it);
+
+        // padding before and the rest after the allocation stay free.
+        if (padding > 0) {
+            m_free_ranges.emplace(free_offset, padding);
+        }
+
+        if (const auto rest = free_size - padding - size; rest > 0) {
+            m_free_ranges.emplace(offset + size, rest);
+        }
+
+        m_free_size -= size;
+
+        return range{offset, size};
+    }
+
+    return std::nullopt;
+}
+
+
+void gl::range_allocator::free(const gl::range_allocator::range& r)
+{
+    if (r.size == 0) {
+        return;
+    }
+
+    assert(r.offset + r.size <= m_capacity);
+
+    auto offset = r.offset;
+    auto size = r.size;
+
+    auto next = m_free_ranges.lower_bound(offset);
+
+    if (next != m_free_ranges.begin()) {
+        auto prev = std::prev(next);
+        assert(prev->first + prev->second <= offset);
+
+        if (prev->first + prev->second == offset) {
+            offset = prev->first;
+            size += prev->second;
+            m_free_ranges.erase(prev);
+        }
+    }
+
+    if (next != m_free_ranges.end()) {
+        assert(r.offset + r.size <= next->first);
+
+        if (r.offset + r.size == next->first) {
+            size += next->second;
+            m_free_ranges.erase(next);
+        }
+    }
+
+    m_free_ranges.emplace(offset, size);
+    m_free_size += r.size;
+}
+
+
+void gl::range_allocator::reset()
+{
+    m_free_ranges.clear();
+
+    if (m_capacity > 0) {
+        m_free_ranges.emplace(0, m_capacity);
+    }
+
+    m_free_size = m_capacity;
+}
+
+
+uint64_t gl::range_allocator::get_capacity() const
+{
+    return m_capacity;
+}
+
+
+uint64_t gl::range_allocator::get_free_size() const
+{
+    return m_free_size;
+}
+
+
+uint64_t gl::range_allocator::get_largest_free_size() const
+{
+    uint64_t largest = 0;
+
+    for (const auto& [offset, size] : m_free_ranges) {
+        largest = std::max(largest, size);
+    }
+
+    return largest;
+}
@@ -0,0 +1,39 @@
+
+
+
+#pragma once
+
+#include <cinttypes>
+#include <map>
+#include <optional>
+
+namespace gl
+{
+    // first fit offset allocator over [0, capacity), freed ranges are coalesced with their free neighbours.
+    class range_allocator
+    {
+    public:
+        struct range
+        {
+            uint64_t offset = 0;
+            uint64_t size = 0;
+        };
+
+        explicit range_allocator(uint64_t capacity = 0);
+        ~range_allocator() = default;
+
+        std::optional<range> allocate(uint64_t size, uint64_t alignment = 1);
+        void free(const range& r);
+        void reset();
+
+        uint64_t get_capacity() const;
+        uint64_t get_free_size() const;
+        uint64_t get_largest_free_size() const;
+
+    private:
+        uint64_t m_capacity;
+        uint64_t m_free_size;
+        // free ranges by offset.
+        std::map<uint64_t, uint64_t> m_free_ranges;
+    };
+} // namespace gl
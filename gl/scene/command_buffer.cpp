@@ -0,0 +1,848 @@
+
+
+#include "command_buffer.hpp"
+
+#include <gl/debug.hpp>
+#include <gl/profiler.hpp>
+
+#include <algorithm>
+#include <optional>
+#include <unordered_map>
+#include <variant>
+
+
+namespace
+{
+    template<uint32_t TextureType>
+    constexpr uint32_t get_texture_target(const gl::texture<TextureType>&)
+    {
+        return TextureType;
+    }
+
+
+    // the program of the material or its fallback while the program is being built.
+    uint32_t get_program(const gl::scene::scene& s, const gl::scene::material& mat)
+    {
+        return s.programs.get_draw_program(mat.get_program());
+    }
+
+
+    bool is_pooled(const gl::scene::scene& s, const gl::scene::drawable& drawable)
+    {
+        const auto& mat = s.materials.at(drawable.material_idx);
+        return s.meshes.at(drawable.mesh_idx).get_pool() >= 0 && mat.get_draw_data_binding(s.shaders.at(get_program(s, mat))).unit >= 0;
+    }
+
+
+    uint64_t get_slot_key(const gl::scene::mesh& mesh)
+    {
+        return uint64_t(mesh.get_pool()) << 32 | mesh.get_pool_slot();
+    }
+
+
+    std::string get_draw_label(const gl::scene::scene& s, const gl::scene::drawable& drawable)
+    {
+        const auto& mat_name = s.materials.at(drawable.material_idx).get_name();
+        const auto& mesh_name = s.meshes.at(drawable.mesh_idx).get_name();
+        return (mat_name.empty() ? "material " + std::to_string(drawable.material_idx) : mat_name)
+            + " / " + (mesh_name.empty() ? "mesh " + std::to_string(drawable.mesh_idx) : mesh_name);
+    }
+
+
+    bool is_same_state(const gl::scene::gpu_state& l, const gl::scene::gpu_state& r)
+    {
+        return std::equal(std::begin(l.color_write), std::end(l.color_write), std::begin(r.color_write))
+            && l.depth_write == r.depth_write
+            && l.depth_func == r.depth_func
+            && l.culling == r.culling
+            && l.blend == r.blend;
+    }
+
+
+    // pooled drawables which can go into one multi draw: same pool and program,
+    // and everything bound per draw except the draw data is the same.
+    template<typename BlockRange>
+    bool can_merge(
+        const gl::scene::scene& s,
+        const gl::scene::drawable& l,
+        const gl::scene::drawable& r,
+        const std::vector<BlockRange>& ranges,
+        const std::vector<uint32_t>& first_ranges,
+        uint32_t l_draw,
+        uint32_t r_draw)
+    {
+        const auto& l_mesh = s.meshes.at(l.mesh_idx);
+        const auto& r_mesh = s.meshes.at(r.mesh_idx);
+
+        if (l.topo != r.topo || l_mesh.get_pool() != r_mesh.get_pool() || !is_pooled(s, r)) {
+            return false;
+        }
+
+        const auto& l_mat = s.materials.at(l.material_idx);
+        const auto& r_mat = s.materials.at(r.material_idx);
+
+        if (get_program(s, l_mat) != get_program(s, r_mat)) {
+            return false;
+        }
+
+        const auto l_ranges = first_ranges[l_draw + 1] - first_ranges[l_draw];
+
+        if (l_ranges != first_ranges[r_draw + 1] - first_ranges[r_draw]) {
+            return false;
+        }
+
+        for (uint32_t i = 0; i < l_ranges; ++i) {
+            if (ranges[first_ranges[l_draw] + i].offset != ranges[first_ranges[r_draw] + i].offset) {
+                return false;
+            }
+        }
+
+        if (l.material_idx == r.material_idx) {
+            return true;
+        }
+
+        const auto& shader = s.shaders.at(get_program(s, l_mat));
+
+        if (!is_same_state(l_mat.get_state(), r_mat.get_state())) {
+            return false;
+        }
+
+        const auto& l_textures = l_mat.get_texture_bindings(shader);
+        const auto& r_textures = r_mat.get_texture_bindings(shader);
+
+        const bool same_textures = std::equal(l_textures.begin(), l_textures.end(), r_textures.begin(), r_textures.end(), [](const auto& a, const auto& b) {
+            return a.texture == b.texture && a.unit == b.unit;
+        });
+
+        if (!same_textures) {
+            return false;
+        }
+
+        const auto& l_params = l_mat.get_parameter_bindings(shader);
+        const auto& r_params = r_mat.get_parameter_bindings(shader);
+
+        return std::equal(l_params.begin(), l_params.end(), r_params.begin(), r_params.end(), [](const auto& a, const auto& b) {
+            return a.location != b.location ? false : a.location < 0 || a.parameter == b.parameter;
+        });
+    }
+} // namespace
+
+
+void gl::scene::command_buffer::resolve_materials(const gl::scene::scene& s, const std::vector<gl::scene::render_command>& commands)
+{
+    for (const auto& command : commands) {
+        if (command.type == render_command::type::draw) {
+            const auto& mat = s.materials.at(s.drawables.at(command.source_index).material_idx);
+            mat.get_texture_bindings(s.shaders.at(s.programs.use(s.shaders, mat.get_program())));
+        }
+    }
+}
+
+
+void gl::scene::command_buffer::clear()
+{
+    m_ops.clear();
+    m_passes.clear();
+    m_framebuffers.clear();
+    m_states.clear();
+    m_uniforms.clear();
+    m_labels.clear();
+    m_block_values.clear();
+    m_blocks_size = 0;
+    m_draw_data.clear();
+    m_frame_draw_data.clear();
+    m_pools.clear();
+    m_slot_owners.clear();
+    m_counts.clear();
+    m_offsets.clear();
+    m_base_vertices.clear();
+}
+
+
+void gl::scene::command_buffer::record(
+    const gl::scene::scene& s,
+    const std::vector<gl::scene::render_command>& commands,
+    size_t first,
+    size_t last,
+    uint32_t uniform_alignment)
+{
+    clear();
+    m_uniform_alignment = uniform_alignment;
+
+    std::vector<block_range> ranges;
+    std::vector<uint32_t> first_ranges;
+    layout_uniform_blocks(s, commands, first, last, ranges, first_ranges);
+
+    // a mesh drawn more than once gets its slot rewritten before the later draws.
+    std::unordered_map<uint64_t, uint32_t> slot_owners;
+
+    // binds already done by the previous ops are not recorded again.
+    uint32_t bound_program = 0;
+    uint32_t bound_vertex_array = 0;
+    std::optional<gpu_state> bound_state;
+    std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> bound_textures;
+    std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> bound_blocks;
+    std::unordered_map<uint64_t, const uint8_t*> set_uniforms;
+
+    auto emit = [this](op_code code, uint32_t a0 = 0, uint32_t a1 = 0, uint32_t a2 = 0, uint32_t a3 = 0, uint32_t a4 = 0) {
+        m_ops.emplace_back(op{code, {a0, a1, a2, a3, a4}});
+    };
+
+    // groups label debug output and gpu zones of the profiler.
+    const bool labelled = gl::debug_build || gl::profiler::get_current() != nullptr;
+
+    auto push_group = [this, &emit](std::string label, uint32_t pass_group = 0) {
+        m_labels.emplace_back(std::move(label));
+        emit(op_code::push_debug_group, m_labels.size() - 1, pass_group);
+    };
+
+    // first uses of the slots are claimed before the draws, append moves the claims of slots
+    // not used by the previous buffers to the frame start.
+    for (size_t command_idx = first; command_idx < last; ++command_idx) {
+        const auto& command = commands[command_idx];
+
+        if (command.type != render_command::type::draw) {
+            continue;
+        }
+
+        const auto& drawable = s.drawables.at(command.source_index);
+
+        if (is_pooled(s, drawable) && slot_owners.emplace(get_slot_key(s.meshes.at(drawable.mesh_idx)), command.source_index).second) {
+            emit(op_code::update_draw_data, add_draw_data(s, command.source_index), 1);
+        }
+    }
+
+    auto bind_texture = [&](uint32_t unit, uint32_t target, uint32_t texture) {
+        const auto binding = std::make_pair(target, texture);
+        if (auto [it, inserted] = bound_textures.emplace(unit, binding); inserted || it->second != binding) {
+            it->second = binding;
+            emit(op_code::bind_texture, unit, target, texture);
+        }
+    };
+
+    auto bind_drawable = [&](const drawable& d, uint32_t draw) {
+        const auto& mesh = s.meshes.at(d.mesh_idx);
+        const auto& mat = s.materials.at(d.material_idx);
+        const auto& shader = s.shaders.at(get_program(s, mat));
+
+        if (const uint32_t vertex_array = s.vertex_sources.at(mesh.get_vertices()); vertex_array != bound_vertex_array) {
+            bound_vertex_array = vertex_array;
+            emit(op_code::bind_vertex_array, vertex_array);
+        }
+
+        if (const uint32_t program = shader; program != bound_program) {
+            bound_program = program;
+            emit(op_code::use_program, program);
+        }
+
+        for (const auto& binding : mat.get_texture_bindings(shader)) {
+            std::visit([&](const auto& t) {
+                bind_texture(binding.unit, get_texture_target(t), uint32_t(t));
+            },
+                       s.textures.at(binding.texture));
+        }
+
+        for (uint32_t i = first_ranges[draw]; i < first_ranges[draw + 1]; ++i) {
+            const auto range = std::make_pair(ranges[i].offset, ranges[i].size);
+            if (auto [it, inserted] = bound_blocks.emplace(ranges[i].binding, range); inserted || it->second != range) {
+                it->second = range;
+                emit(op_code::bind_uniform_block, ranges[i].binding, ranges[i].offset, ranges[i].size);
+            }
+        }
+
+        for (const auto& binding : mat.get_parameter_bindings(shader)) {
+            if (binding.location < 0) {
+                continue;
+            }
+
+            const auto& parameter = s.parameters.at(binding.parameter);
+            const auto key = uint64_t(bound_program) << 32 | uint32_t(binding.location);
+
+            if (auto [it, inserted] = set_uniforms.emplace(key, parameter.get_data()); !inserted && it->second == parameter.get_data()) {
+                continue;
+            } else {
+                it->second = parameter.get_data();
+            }
+
+            emit(op_code::set_uniform, add_uniform(s, shader, binding.parameter, binding.location));
+        }
+
+        if (!bound_state || !is_same_state(*bound_state, mat.get_state())) {
+            bound_state = mat.get_state();
+            m_states.emplace_back(mat.get_state());
+            emit(op_code::set_state, m_states.size() - 1);
+        }
+    };
+
+    uint32_t draw_idx = 0;
+
+    for (size_t command_idx = first; command_idx < last; ++command_idx) {
+        const auto& command = commands[command_idx];
+
+        switch (command.type) {
+            case render_command::type::pass:
+                if (labelled) {
+                    push_group("pass " + std::to_string(command.source_index), 1);
+                }
+                m_passes.emplace_back(&s.passes.at(command.source_index));
+                emit(op_code::bind_pass, m_passes.size() - 1);
+                // unbind of the previous pass resets the gpu state.
+                bound_state.reset();
+                break;
+            case render_command::type::draw:
+                {
+                    const auto& drawable = s.drawables.at(command.source_index);
+                    const auto& mesh = s.meshes.at(drawable.mesh_idx);
+
+                    // binds are in the group of their draw, so a capture shows what each draw changes.
+                    if (labelled) {
+                        push_group(get_draw_label(s, drawable));
+                    }
+
+                    bind_drawable(drawable, draw_idx);
+
+                    if (!is_pooled(s, drawable)) {
+                        ++draw_idx;
+
+                        if (mesh.get_indices_size() > 0) {
+                            emit(op_code::draw_elements, uint32_t(drawable.topo), mesh.get_indices_size(), uint32_t(mesh.get_indices_type()), mesh.get_indices_offset(), 0);
+                        } else {
+                            emit(op_code::draw_arrays, uint32_t(drawable.topo), mesh.get_vertices_size());
+                        }
+
+                        if (labelled) {
+                            emit(op_code::pop_debug_group);
+                        }
+                        break;
+                    }
+
+                    const auto& pool = s.vertex_pools.at(mesh.get_pool());
+                    const auto& mat = s.materials.at(drawable.material_idx);
+                    const auto& binding = mat.get_draw_data_binding(s.shaders.at(get_program(s, mat)));
+
+                    if (auto& owner = slot_owners[get_slot_key(mesh)]; owner != command.source_index) {
+                        owner = command.source_index;
+                        emit(op_code::update_draw_data, add_draw_data(s, command.source_index), 0);
+                    }
+
+                    bind_texture(binding.unit, GL_TEXTURE_BUFFER, pool.get_draw_data_texture());
+
+                    const auto first_draw_idx = draw_idx;
+                    const auto first_arg = m_counts.size();
+
+                    for (;;) {
+                        const auto& batch_mesh = s.meshes.at(s.drawables.at(commands[command_idx].source_index).mesh_idx);
+                        m_counts.emplace_back(batch_mesh.get_indices_size());
+                        m_offsets.emplace_back(reinterpret_cast<const void*>(uintptr_t(batch_mesh.get_indices_offset())));
+                        m_base_vertices.emplace_back(batch_mesh.get_base_vertex());
+                        ++draw_idx;
+
+                        if (command_idx + 1 == last || commands[command_idx + 1].type != render_command::type::draw) {
+                            break;
+                        }
+
+                        const auto next_idx = commands[command_idx + 1].source_index;
+                        const auto& next = s.drawables.at(next_idx);
+
+                        // a slot rewrite has to wait until the draws reading the old data are issued.
+                        if (!can_merge(s, drawable, next, ranges, first_ranges, first_draw_idx, draw_idx)
+                            || slot_owners[get_slot_key(s.meshes.at(next.mesh_idx))] != next_idx) {
+                            break;
+                        }
+
+                        ++command_idx;
+                    }
+
+                    const auto args_count = m_counts.size() - first_arg;
+
+                    if (args_count == 1) {
+                        emit(op_code::draw_elements, uint32_t(drawable.topo), m_counts.back(), uint32_t(mesh.get_indices_type()), mesh.get_indices_offset(), uint32_t(m_base_vertices.back()));
+                        m_counts.pop_back();
+                        m_offsets.pop_back();
+                        m_base_vertices.pop_back();
+                    } else {
+                        emit(op_code::multi_draw_elements, uint32_t(drawable.topo), uint32_t(mesh.get_indices_type()), first_arg, args_count);
+                    }
+
+                    if (labelled) {
+                        if (args_count > 1) {
+                            m_labels.back() += " + " + std::to_string(args_count - 1) + " draws";
+                        }
+                        emit(op_code::pop_debug_group);
+                    }
+                }
+                break;
+            case render_command::type::blit:
+                {
+                    const auto& src_pass = s.passes.at(command.source_index);
+                    const auto& dst_pass = s.passes.at(command.dst_index);
+                    m_framebuffers.emplace_back(&s.framebuffers.at(src_pass.get_framebuffer_idx()));
+                    m_framebuffers.emplace_back(&s.framebuffers.at(dst_pass.get_framebuffer_idx()));
+                    emit(op_code::blit, m_framebuffers.size() - 2, m_framebuffers.size() - 1);
+                }
+                break;
+        }
+    }
+}
+
+
+void gl::scene::command_buffer::append(const gl::scene::command_buffer& other)
+{
+    m_uniform_alignment = std::max(m_uniform_alignment, other.m_uniform_alignment);
+
+    const uint32_t passes_base = m_passes.size();
+    const uint32_t framebuffers_base = m_framebuffers.size();
+    const uint32_t states_base = m_states.size();
+    const uint32_t uniforms_base = m_uniforms.size();
+    const uint32_t labels_base = m_labels.size();
+    const uint32_t draw_data_base = m_draw_data.size();
+    const uint32_t args_base = m_counts.size();
+    const uint32_t blocks_base = allocate_block(other.m_blocks_size);
+
+    m_passes.insert(m_passes.end(), other.m_passes.begin(), other.m_passes.end());
+    m_framebuffers.insert(m_framebuffers.end(), other.m_framebuffers.begin(), other.m_framebuffers.end());
+    m_states.insert(m_states.end(), other.m_states.begin(), other.m_states.end());
+    m_uniforms.insert(m_uniforms.end(), other.m_uniforms.begin(), other.m_uniforms.end());
+    m_labels.insert(m_labels.end(), other.m_labels.begin(), other.m_labels.end());
+    m_draw_data.insert(m_draw_data.end(), other.m_draw_data.begin(), other.m_draw_data.end());
+    m_counts.insert(m_counts.end(), other.m_counts.begin(), other.m_counts.end());
+    m_offsets.insert(m_offsets.end(), other.m_offsets.begin(), other.m_offsets.end());
+    m_base_vertices.insert(m_base_vertices.end(), other.m_base_vertices.begin(), other.m_base_vertices.end());
+
+    for (auto value : other.m_block_values) {
+        value.offset += blocks_base;
+        m_block_values.emplace_back(value);
+    }
+
+    for (const auto index : other.m_frame_draw_data) {
+        m_frame_draw_data.emplace_back(draw_data_base + index);
+    }
+
+    for (const auto* pool : other.m_pools) {
+        if (std::find(m_pools.begin(), m_pools.end(), pool) == m_pools.end()) {
+            m_pools.emplace_back(pool);
+        }
+    }
+
+    m_ops.reserve(m_ops.size() + other.m_ops.size());
+
+    for (auto op : other.m_ops) {
+        auto* args = op.args;
+
+        switch (op.code) {
+            case op_code::bind_pass:
+                args[0] += passes_base;
+                break;
+            case op_code::blit:
+                args[0] += framebuffers_base;
+                args[1] += framebuffers_base;
+                break;
+            case op_code::bind_uniform_block:
+                args[1] += blocks_base;
+                break;
+            case op_code::set_uniform:
+                args[0] += uniforms_base;
+                break;
+            case op_code::set_state:
+                args[0] += states_base;
+                break;
+            case op_code::update_draw_data:
+                {
+                    args[0] += draw_data_base;
+
+                    const auto& value = m_draw_data[args[0]];
+                    const auto [owner, inserted] = m_slot_owners.emplace(std::make_pair(value.pool, value.slot), value.drawable);
+
+                    if (args[1] != 0 && inserted) {
+                        // nothing before reads the slot, write it with the rest of the frame data.
+                        m_frame_draw_data.emplace_back(args[0]);
+
+                        if (std::find(m_pools.begin(), m_pools.end(), value.pool) == m_pools.end()) {
+                            m_pools.emplace_back(value.pool);
+                        }
+                        continue;
+                    }
+
+                    if (owner->second == value.drawable && !inserted) {
+                        continue;
+                    }
+
+                    owner->second = value.drawable;
+                    args[1] = 0;
+                }
+                break;
+            case op_code::multi_draw_elements:
+                args[2] += args_base;
+                break;
+            case op_code::push_debug_group:
+                args[0] += labels_base;
+                break;
+            default:
+                break;
+        }
+
+        m_ops.emplace_back(op);
+    }
+}
+
+
+void gl::scene::command_buffer::prepare(const gl::scene::scene& s) const
+{
+    s.uniforms.begin();
+
+    if (m_blocks_size > 0) {
+        const auto base = s.uniforms.allocate(m_blocks_size);
+        assert(base == 0);
+        auto* blocks = s.uniforms.get_data(base);
+
+        for (const auto& value : m_block_values) {
+            if (value.columns == 0) {
+                std::memcpy(blocks + value.offset, value.data, value.size);
+                continue;
+            }
+
+            for (uint32_t c = 0; c < value.columns; ++c) {
+                std::memcpy(blocks + value.offset + c * 4 * sizeof(float), value.data + c * value.column_size, value.column_size);
+            }
+        }
+    }
+
+    s.uniforms.upload();
+
+    for (const auto index : m_frame_draw_data) {
+        write_draw_data(m_draw_data[index]);
+    }
+
+    for (const auto* pool : m_pools) {
+        pool->upload_draw_data();
+    }
+}
+
+
+const gl::scene::pass* gl::scene::command_buffer::execute(const gl::scene::scene& s) const
+{
+    const gl::scene::pass* curr_pass = nullptr;
+    // a pass group stays open until the next pass, buffers of one pass may be appended from several records.
+    bool pass_group = false;
+    auto* profiler = gl::profiler::get_current();
+    const bool draw_zones = profiler != nullptr && profiler->has_draw_zones();
+
+    auto end_pass_group = [&]() {
+        gl::pop_debug_group();
+        if (profiler != nullptr) {
+            profiler->end_gpu_zone();
+        }
+    };
+    m_upload_counters = {};
+
+    for (const auto& op : m_ops) {
+        const auto* args = op.args;
+
+        switch (op.code) {
+            case op_code::bind_pass:
+                if (curr_pass) {
+                    curr_pass->unbind();
+                }
+                curr_pass = m_passes[args[0]];
+                curr_pass->bind();
+                break;
+            case op_code::blit:
+                m_framebuffers[args[0]]->blit(*m_framebuffers[args[1]]);
+                break;
+            case op_code::use_program:
+                s.state.use_program(args[0]);
+                break;
+            case op_code::bind_vertex_array:
+                s.state.bind_vertex_array(args[0]);
+                break;
+            case op_code::bind_texture:
+                s.state.bind_texture(args[0], args[1], args[2]);
+                break;
+            case op_code::bind_uniform_block:
+                s.state.bind_uniform_buffer(args[0], s.uniforms, args[1], args[2]);
+                break;
+            case op_code::set_uniform:
+                set_uniform(m_uniforms[args[0]]);
+                break;
+            case op_code::set_state:
+                curr_pass->set_state(m_states[args[0]]);
+                break;
+            case op_code::update_draw_data:
+                write_draw_data(m_draw_data[args[0]]);
+                m_draw_data[args[0]].pool->upload_draw_data(m_draw_data[args[0]].slot);
+                break;
+            case op_code::draw_arrays:
+                glDrawArrays(args[0], 0, args[1]);
+                break;
+            case op_code::draw_elements:
+                glDrawElementsBaseVertex(args[0], args[1], args[2], reinterpret_cast<void*>(uintptr_t(args[3])), int32_t(args[4]));
+                break;
+            case op_code::multi_draw_elements:
+                glMultiDrawElementsBaseVertex(
+                    args[0], m_counts.data() + args[2], args[1], const_cast<void* const*>(m_offsets.data() + args[2]), args[3], m_base_vertices.data() + args[2]);
+                break;
+            case op_code::push_debug_group:
+                if (args[1] != 0) {
+                    if (pass_group) {
+                        end_pass_group();
+                    }
+                    pass_group = true;
+                }
+                gl::push_debug_group(m_labels[args[0]]);
+                if (args[1] != 0 ? profiler != nullptr : draw_zones) {
+                    profiler->begin_gpu_zone(m_labels[args[0]]);
+                }
+                break;
+            case op_code::pop_debug_group:
+                gl::pop_debug_group();
+                if (draw_zones) {
+                    profiler->end_gpu_zone();
+                }
+                break;
+        }
+    }
+
+    if (pass_group) {
+        end_pass_group();
+    }
+
+    return curr_pass;
+}
+
+
+const std::vector<gl::scene::command_buffer::op>& gl::scene::command_buffer::get_ops() const
+{
+    return m_ops;
+}
+
+
+const gl::scene::command_buffer::upload_counters& gl::scene::command_buffer::get_upload_counters() const
+{
+    return m_upload_counters;
+}
+
+
+void gl::scene::command_buffer::set_uniform(const gl::scene::command_buffer::uniform_value& value) const
+{
+    constexpr uint32_t sizes[]{4, 4, 8, 8, 12, 12, 16, 16, 16, 36, 64};
+    const auto size = sizes[uint32_t(value.kind)];
+
+    if (!value.program->update_uniform_version(value.location, value.parameter, *value.version)) {
+        ++m_upload_counters.skipped;
+        m_upload_counters.skipped_bytes += size;
+        return;
+    }
+
+    ++m_upload_counters.uploaded;
+    m_upload_counters.uploaded_bytes += size;
+
+    const auto* f = reinterpret_cast<const float*>(value.data);
+    const auto* i = reinterpret_cast<const int32_t*>(value.data);
+
+    switch (value.kind) {
+        case uniform_kind::f1:
+            glUniform1fv(value.location, 1, f);
+            break;
+        case uniform_kind::i1:
+            glUniform1iv(value.location, 1, i);
+            break;
+        case uniform_kind::f2:
+            glUniform2fv(value.location, 1, f);
+            break;
+        case uniform_kind::i2:
+            glUniform2iv(value.location, 1, i);
+            break;
+        case uniform_kind::f3:
+            glUniform3fv(value.location, 1, f);
+            break;
+        case uniform_kind::i3:
+            glUniform3iv(value.location, 1, i);
+            break;
+        case uniform_kind::f4:
+            glUniform4fv(value.location, 1, f);
+            break;
+        case uniform_kind::i4:
+            glUniform4iv(value.location, 1, i);
+            break;
+        case uniform_kind::m2:
+            glUniformMatrix2fv(value.location, 1, GL_FALSE, f);
+            break;
+        case uniform_kind::m3:
+            glUniformMatrix3fv(value.location, 1, GL_FALSE, f);
+            break;
+        case uniform_kind::m4:
+            glUniformMatrix4fv(value.location, 1, GL_FALSE, f);
+            break;
+    }
+}
+
+
+// rows of the vertex pool texture buffer: mvp, model, (anim key, 0, 0, 0).
+void gl::scene::command_buffer::write_draw_data(const gl::scene::command_buffer::draw_data_value& value)
+{
+    auto* dst = value.pool->get_draw_data(value.slot);
+    std::fill(dst, dst + vertex_pool::draw_data_texels * 4, 0.f);
+
+    if (value.mvp) {
+        std::memcpy(dst, value.mvp, sizeof(float) * 16);
+    }
+
+    if (value.model) {
+        std::memcpy(dst + 16, value.model, sizeof(float) * 16);
+    }
+
+    if (value.anim_key) {
+        int32_t anim_key;
+        std::memcpy(&anim_key, value.anim_key, sizeof(anim_key));
+        dst[32] = float(anim_key);
+    }
+}
+
+
+uint32_t gl::scene::command_buffer::allocate_block(uint32_t size)
+{
+    const uint32_t offset = (m_blocks_size + m_uniform_alignment - 1) / m_uniform_alignment * m_uniform_alignment;
+    m_blocks_size = offset + size;
+    return offset;
+}
+
+
+void gl::scene::command_buffer::layout_uniform_blocks(
+    const gl::scene::scene& s,
+    const std::vector<gl::scene::render_command>& commands,
+    size_t first,
+    size_t last,
+    std::vector<block_range>& ranges,
+    std::vector<uint32_t>& first_ranges)
+{
+    // frame block members are frame globals, one range of it is shared by all drawables of the buffer.
+    std::optional<block_range> frame_range;
+
+    for (size_t command_idx = first; command_idx < last; ++command_idx) {
+        const auto& command = commands[command_idx];
+
+        if (command.type != render_command::type::draw) {
+            continue;
+        }
+
+        const auto& mat = s.materials.at(s.drawables.at(command.source_index).material_idx);
+        const auto& shader = s.shaders.at(get_program(s, mat));
+        const auto first_range = ranges.size();
+
+        first_ranges.emplace_back(first_range);
+
+        for (const auto& block : shader.get_uniform_blocks()) {
+            if (block.binding == gl::program::frame_block_binding) {
+                if (!frame_range) {
+                    frame_range = block_range{uint32_t(block.binding), allocate_block(block.size), uint32_t(block.size)};
+                }
+
+                assert(frame_range->size == uint32_t(block.size));
+                ranges.emplace_back(*frame_range);
+            } else {
+                ranges.emplace_back(block_range{uint32_t(block.binding), allocate_block(block.size), uint32_t(block.size)});
+            }
+        }
+
+        for (const auto& binding : mat.get_parameter_bindings(shader)) {
+            if (binding.block_binding < 0) {
+                continue;
+            }
+
+            const auto range = std::find_if(ranges.begin() + first_range, ranges.end(), [&binding](const block_range& r) {
+                return r.binding == uint32_t(binding.block_binding);
+            });
+
+            assert(range != ranges.end());
+
+            const auto& parameter = s.parameters.at(binding.parameter);
+            const auto type_size = get_param_type_size(parameter.get_param_type());
+            const auto components_size = get_param_components_size(parameter.get_component_type());
+
+            uint32_t columns = 0;
+
+            switch (parameter.get_component_type()) {
+                case parameter_component_type::mat2:
+                    columns = 2;
+                    break;
+                case parameter_component_type::mat3:
+                    columns = 3;
+                    break;
+                default:
+                    break;
+            }
+
+            m_block_values.emplace_back(block_value{
+                range->offset + uint32_t(binding.block_offset),
+                columns,
+                columns > 0 ? components_size / columns * type_size : 0,
+                components_size * type_size,
+                parameter.get_data()});
+        }
+    }
+
+    first_ranges.emplace_back(ranges.size());
+}
+
+
+uint32_t gl::scene::command_buffer::add_uniform(const gl::scene::scene& s, const gl::program& program, uint32_t parameter, int32_t location)
+{
+    const auto p = s.parameters.at(parameter);
+
+    const bool is_float = p.get_param_type() == parameter_type::f32;
+    uniform_kind kind;
+
+    switch (p.get_component_type()) {
+        case parameter_component_type::scalar:
+            kind = is_float ? uniform_kind::f1 : uniform_kind::i1;
+            break;
+        case parameter_component_type::vec2:
+            kind = is_float ? uniform_kind::f2 : uniform_kind::i2;
+            break;
+        case parameter_component_type::vec3:
+            kind = is_float ? uniform_kind::f3 : uniform_kind::i3;
+            break;
+        case parameter_component_type::vec4:
+            kind = is_float ? uniform_kind::f4 : uniform_kind::i4;
+            break;
+        case parameter_component_type::mat2:
+            kind = uniform_kind::m2;
+            break;
+        case parameter_component_type::mat3:
+            kind = uniform_kind::m3;
+            break;
+        case parameter_component_type::mat4:
+            kind = uniform_kind::m4;
+            break;
+    }
+
+    if (!is_float && kind >= uniform_kind::m2) {
+        throw std::runtime_error("unsupported type");
+    }
+
+    m_uniforms.emplace_back(uniform_value{&program, location, kind, p.get_data(), parameter, &s.parameters.get_version(parameter)});
+    return m_uniforms.size() - 1;
+}
+
+
+uint32_t gl::scene::command_buffer::add_draw_data(const gl::scene::scene& s, uint32_t drawable_idx)
+{
+    const auto& d = s.drawables.at(drawable_idx);
+    const auto& mesh = s.meshes.at(d.mesh_idx);
+    const auto& mat = s.materials.at(d.material_idx);
+    const auto& binding = mat.get_draw_data_binding(s.shaders.at(get_program(s, mat)));
+
+    auto get_data = [&s](int32_t parameter) {
+        return parameter >= 0 ? s.parameters.at(parameter).get_data() : nullptr;
+    };
+
+    m_draw_data.emplace_back(draw_data_value{
+        &s.vertex_pools.at(mesh.get_pool()),
+        mesh.get_pool_slot(),
+        drawable_idx,
+        get_data(binding.mvp),
+        get_data(binding.model),
+        get_data(binding.anim_key)});
+
+    return m_draw_data.size() - 1;
+}
@@ -0,0 +1,173 @@
+
+
+#pragma once
+
+#include <gl/scene/scene.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+
+namespace gl::scene
+{
+    // render commands recorded into ops with resolved gl names, uniform locations, texture units and draw arguments.
+    // recording reads the scene only, so buffers of different command ranges can be recorded on different threads
+    // once the materials of the commands are resolved. buffers are appended in order into one frame buffer,
+    // executing it is the only part which calls gl.
+    class command_buffer
+    {
+    public:
+        enum class op_code : uint32_t
+        {
+            // pass index.
+            bind_pass,
+            // source and destination framebuffer indices.
+            blit,
+            // program name.
+            use_program,
+            // vertex array name.
+            bind_vertex_array,
+            // unit, target, texture name.
+            bind_texture,
+            // binding, offset in the uniform stream, size.
+            bind_uniform_block,
+            // uniform value index.
+            set_uniform,
+            // state index, applied to the bound pass.
+            set_state,
+            // draw data index, 1 for the first use of the slot in the buffer. written and uploaded in place.
+            update_draw_data,
+            // topology, vertices count.
+            draw_arrays,
+            // topology, indices count, indices type, indices offset, base vertex.
+            draw_elements,
+            // topology, indices type, first and count of the multi draw arguments.
+            multi_draw_elements,
+            // label index, 1 for a pass group, it closes the group of the previous pass.
+            // groups are recorded in debug builds or with a current profiler only, they are its gpu zones.
+            push_debug_group,
+            pop_debug_group
+        };
+
+        struct op
+        {
+            op_code code;
+            uint32_t args[5];
+        };
+
+        // default block uniforms of the last execute.
+        struct upload_counters
+        {
+            uint32_t uploaded = 0;
+            uint32_t skipped = 0;
+            uint64_t uploaded_bytes = 0;
+            uint64_t skipped_bytes = 0;
+        };
+
+        command_buffer() = default;
+        ~command_buffer() = default;
+
+        // starts linking programs of the materials and resolves their texture and parameter bindings
+        // against the programs or their fallbacks, not thread safe, call before recording.
+        static void resolve_materials(const scene& s, const std::vector<render_command>& commands);
+
+        void clear();
+        // records commands [first, last), uniform blocks ranges are aligned to uniform_alignment.
+        void record(const scene& s, const std::vector<render_command>& commands, size_t first, size_t last, uint32_t uniform_alignment);
+        // appends the ops of the buffer recorded after this one.
+        // first uses of the draw data slots not used before are moved to the frame start.
+        void append(const command_buffer& other);
+
+        // packs uniform blocks and frame draw data and uploads them.
+        void prepare(const scene& s) const;
+        // returns the pass bound by the last bind_pass op, it is left bound.
+        const pass* execute(const scene& s) const;
+
+        const std::vector<op>& get_ops() const;
+        const upload_counters& get_upload_counters() const;
+
+    private:
+        enum class uniform_kind : uint32_t
+        {
+            f1, i1, f2, i2, f3, i3, f4, i4, m2, m3, m4
+        };
+
+        // uploaded only if the program has another version of the data at the location.
+        struct uniform_value
+        {
+            const gl::program* program;
+            int32_t location;
+            uniform_kind kind;
+            const uint8_t* data;
+            uint32_t parameter;
+            const uint32_t* version;
+        };
+
+        // std140 member, matrix columns are padded to vec4.
+        struct block_value
+        {
+            uint32_t offset;
+            uint32_t columns;
+            uint32_t column_size;
+            uint32_t size;
+            const uint8_t* data;
+        };
+
+        struct draw_data_value
+        {
+            const vertex_pool* pool;
+            uint32_t slot;
+            uint32_t drawable;
+            const uint8_t* mvp;
+            const uint8_t* model;
+            const uint8_t* anim_key;
+        };
+
+        struct block_range
+        {
+            uint32_t binding;
+            uint32_t offset;
+            uint32_t size;
+        };
+
+        void set_uniform(const uniform_value& value) const;
+        static void write_draw_data(const draw_data_value& value);
+
+        uint32_t allocate_block(uint32_t size);
+        // ranges of the i-th draw are [first_ranges[i], first_ranges[i + 1]).
+        void layout_uniform_blocks(
+            const scene& s,
+            const std::vector<render_command>& commands,
+            size_t first,
+            size_t last,
+            std::vector<block_range>& ranges,
+            std::vector<uint32_t>& first_ranges);
+        uint32_t add_uniform(const scene& s, const gl::program& program, uint32_t parameter, int32_t location);
+        uint32_t add_draw_data(const scene& s, uint32_t drawable_idx);
+
+        std::vector<op> m_ops;
+
+        std::vector<const pass*> m_passes;
+        std::vector<const framebuffer*> m_framebuffers;
+        std::vector<gpu_state> m_states;
+        std::vector<uniform_value> m_uniforms;
+        std::vector<std::string> m_labels;
+
+        std::vector<block_value> m_block_values;
+        uint32_t m_blocks_size{0};
+        uint32_t m_uniform_alignment{1};
+
+        std::vector<draw_data_value> m_draw_data;
+        // draw data written before the ops, and their pools.
+        std::vector<uint32_t> m_frame_draw_data;
+        std::vector<const vertex_pool*> m_pools;
+        // drawable owning each slot after the last op, for append.
+        std::map<std::pair<const vertex_pool*, uint32_t>, uint32_t> m_slot_owners;
+
+        mutable upload_counters m_upload_counters;
+
+        std::vector<int32_t> m_counts;
+        std::vector<const void*> m_offsets;
+        std::vector<int32_t> m_base_vertices;
+    };
+} // namespace gl::scene
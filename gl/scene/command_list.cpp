@@ -0,0 +1,138 @@
+
+
+#include "command_list.hpp"
+
+#include <gl/debug.hpp>
+#include <gl/profiler.hpp>
+
+#include <algorithm>
+#include <exception>
+
+
+void gl::scene::command_list::compile(
+    const gl::scene::scene& s,
+    const std::vector<gl::scene::render_command>& commands,
+    ::utils::worker_pool* pool,
+    uint32_t chunk_size)
+{
+    assert(chunk_size > 0);
+
+    // material bindings are resolved lazily, which is not safe to do on the workers.
+    command_buffer::resolve_materials(s, commands);
+
+    s.uniforms.begin();
+    const auto uniform_alignment = s.uniforms.get_alignment();
+
+    const uint32_t chunks_count = pool != nullptr ? (commands.size() + chunk_size - 1) / chunk_size : 1;
+    m_chunks.resize(std::max(chunks_count, 1u));
+
+    if (chunks_count <= 1) {
+        m_chunks.front().record(s, commands, 0, commands.size(), uniform_alignment);
+    } else {
+        std::vector<std::exception_ptr> errors(chunks_count);
+
+        pool->run(chunks_count, [&](uint32_t chunk) {
+            try {
+                const size_t first = size_t(chunk) * chunk_size;
+                m_chunks[chunk].record(s, commands, first, std::min(first + chunk_size, commands.size()), uniform_alignment);
+            } catch (...) {
+                errors[chunk] = std::current_exception();
+            }
+        });
+
+        for (const auto& error : errors) {
+            if (error) {
+                std::rethrow_exception(error);
+            }
+        }
+    }
+
+    m_commands.clear();
+
+    for (const auto& chunk : m_chunks) {
+        m_commands.append(chunk);
+    }
+
+    m_source = commands;
+    m_signature = get_signature(s);
+    m_compiled = true;
+}
+
+
+bool gl::scene::command_list::update(
+    const gl::scene::scene& s,
+    const std::vector<gl::scene::render_command>& commands,
+    ::utils::worker_pool* pool,
+    uint32_t chunk_size)
+{
+    gl::cpu_zone zone("command_list::update");
+    s.programs.poll(s.shaders);
+
+    const bool same_commands = std::equal(m_source.begin(), m_source.end(), commands.begin(), commands.end(), [](const auto& l, const auto& r) {
+        return l.type == r.type && l.source_index == r.source_index && l.dst_index == r.dst_index;
+    });
+
+    if (m_compiled && same_commands && m_signature == get_signature(s)) {
+        return false;
+    }
+
+    compile(s, commands, pool, chunk_size);
+    return true;
+}
+
+
+void gl::scene::command_list::invalidate()
+{
+    m_compiled = false;
+}
+
+
+void gl::scene::command_list::replay(const gl::scene::scene& s, uint32_t surface_width, uint32_t surface_height, uint32_t surface_framebuffer) const
+{
+    assert(m_compiled);
+    gl::cpu_zone zone("command_list::replay");
+
+    // anything may have been bound outside of the scene since the last frame.
+    s.state.invalidate();
+    s.state.reset_counters();
+
+    m_commands.prepare(s);
+    const auto* curr_pass = m_commands.execute(s);
+
+    s.state.bind_vertex_array(0);
+    s.state.use_program(0);
+
+    GL_CHECK_ERRORS();
+
+    if (curr_pass) {
+        if (surface_width > 0 && surface_height > 0) {
+            s.framebuffers[curr_pass->get_framebuffer_idx()].blit(surface_width, surface_height, surface_framebuffer);
+        }
+        curr_pass->unbind();
+    }
+}
+
+
+const gl::scene::command_buffer& gl::scene::command_list::get_commands() const
+{
+    return m_commands;
+}
+
+
+gl::scene::command_list::signature gl::scene::command_list::get_signature(const gl::scene::scene& s)
+{
+    return {
+        s.drawables.size(),
+        s.meshes.size(),
+        s.materials.size(),
+        s.shaders.size(),
+        s.parameters.size(),
+        s.textures.size(),
+        s.passes.size(),
+        s.framebuffers.size(),
+        s.vertex_sources.size(),
+        s.vertex_pools.size(),
+        s.programs.get_version(),
+        // groups are recorded for the profiler.
+        gl::profiler::get_current() != nullptr};
+}
@@ -0,0 +1,48 @@
+
+
+#pragma once
+
+#include <gl/scene/command_buffer.hpp>
+
+#include <worker_pool.hpp>
+
+#include <array>
+#include <vector>
+
+namespace gl::scene
+{
+    // scene commands compiled into a command_buffer when the commands or the scene change and replayed every frame.
+    // with a worker pool the commands are recorded in chunks on the workers and appended in order,
+    // gl calls stay on the calling thread.
+    class command_list
+    {
+    public:
+        command_list() = default;
+        ~command_list() = default;
+
+        void compile(const scene& s, const std::vector<render_command>& commands, ::utils::worker_pool* pool = nullptr, uint32_t chunk_size = 1024);
+        // compiles if the commands or the scene containers changed since the last compile
+        // or a program drawn with a fallback was built, returns true if it did.
+        bool update(const scene& s, const std::vector<render_command>& commands, ::utils::worker_pool* pool = nullptr, uint32_t chunk_size = 1024);
+        // next update compiles, for changes update can not see like material textures or parameters.
+        void invalidate();
+
+        // the last bound pass is blitted to the surface unless its size is zero.
+        // surface_framebuffer is 0 for a window, offscreen surfaces have a framebuffer of their own.
+        void replay(const scene& s, uint32_t surface_width, uint32_t surface_height, uint32_t surface_framebuffer = 0) const;
+
+        const command_buffer& get_commands() const;
+
+    private:
+        using signature = std::array<size_t, 12>;
+
+        static signature get_signature(const scene& s);
+
+        std::vector<command_buffer> m_chunks;
+        command_buffer m_commands;
+
+        std::vector<render_command> m_source;
+        signature m_signature{};
+        bool m_compiled{false};
+    };
+} // namespace gl::scene
@@ -15,16 +15,16 @@ gl::scene::framebuffer::framebuffer(
 }
 
 
-void gl::scene::framebuffer::blit(uint32_t dst_width, uint32_t dst_height) const
+void gl::scene::framebuffer::blit(uint32_t dst_width, uint32_t dst_height, uint32_t dst_handler) const
 {
-    m_scene.fbos.at(m_handler_idx).blit(0, m_width, m_height, dst_width, dst_height);
+    m_scene.fbos.at(m_handler_idx).blit(dst_handler, m_width, m_height, dst_width, dst_height, m_blit_filter == blit_filter::nearest ? GL_NEAREST : GL_LINEAR);
 }
 
 
 void gl::scene::framebuffer::blit(const gl::scene::framebuffer& dst) const
 {
     const auto& dst_handler = m_scene.fbos.at(dst.m_handler_idx);
-    m_scene.fbos.at(m_handler_idx).blit(dst_handler, m_width, m_height, dst.m_width, dst.m_height);
+    m_scene.fbos.at(m_handler_idx).blit(dst_handler, m_width, m_height, dst.m_width, dst.m_height, m_blit_filter == blit_filter::nearest ? GL_NEAREST : GL_LINEAR);
 }
 
 
@@ -48,40 +48,10 @@ void gl::scene::framebuffer::add_attachment(gl::scene::framebuffer::attachment_t
 {
     assert(target != max_attachments);
 
-    const auto& curr_attachment = m_scene.attachments.at(idx);
+    m_scene.attachments.at(idx).resize(m_width, m_height);
+    m_attachments.at(target) = idx;
 
-    const auto& attachment_texture = std::get<gl::texture<GL_TEXTURE_2D>>(m_scene.textures.at(curr_attachment.get_handler_idx()));
-
-    int32_t draw_fb;
-
-    curr_attachment.resize(m_width, m_height);
-
-    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_fb);
-
-    {
-        bind_guard g(*this);
-
-        m_attachments.at(target) = idx;
-
-        if (target == depth) {
-            assert(curr_attachment.get_type() == attachment_type::depth24f);
-            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, attachment_texture, 0);
-        } else {
-            assert(curr_attachment.get_type() != attachment_type::depth24f);
-            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + target, GL_TEXTURE_2D, attachment_texture, 0);
-            std::vector<GLenum> drawbufs;
-
-            for (size_t i = 0; i < max_attachments - 1; ++i) {
-                if (m_attachments.at(i) >= 0) {
-                    drawbufs.emplace_back(GL_COLOR_ATTACHMENT0 + i);
-                }
-            }
-
-            glDrawBuffers(drawbufs.size(), drawbufs.data());
-        }
-    }
-
-    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_fb);
+    attach(target);
 }
 
 
@@ -141,3 +111,63 @@ void gl::scene::framebuffer::clear(const std::function<gl::scene::pass_behaviour
         }
     }
 }
+
+
+void gl::scene::framebuffer::set_size(uint32_t w, uint32_t h)
+{
+    m_width = w;
+    m_height = h;
+
+    for (size_t i = 0; i < max_attachments; ++i) {
+        if (m_attachments.at(i) >= 0) {
+            attach(attachment_target(i));
+        }
+    }
+}
+
+
+void gl::scene::framebuffer::set_blit_filter(gl::scene::blit_filter filter)
+{
+    m_blit_filter = filter;
+}
+
+
+gl::scene::blit_filter gl::scene::framebuffer::get_blit_filter() const
+{
+    return m_blit_filter;
+}
+
+
+void gl::scene::framebuffer::attach(gl::scene::framebuffer::attachment_target target) const
+{
+    const auto& curr_attachment = m_scene.attachments.at(m_attachments.at(target));
+
+    const auto& attachment_texture = std::get<gl::texture<GL_TEXTURE_2D>>(m_scene.textures.at(curr_attachment.get_handler_idx()));
+
+    int32_t draw_fb;
+
+    glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &draw_fb);
+
+    {
+        bind_guard g(*this);
+
+        if (target == depth) {
+            assert(curr_attachment.get_type() == attachment_type::depth24f);
+            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_TEXTURE_2D, attachment_texture, 0);
+        } else {
+            assert(curr_attachment.get_type() != attachment_type::depth24f);
+            glFramebufferTexture2D(GL_DRAW_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + target, GL_TEXTURE_2D, attachment_texture, 0);
+            std::vector<GLenum> drawbufs;
+
+            for (size_t i = 0; i < max_attachments - 1; ++i) {
+                if (m_attachments.at(i) >= 0) {
+                    drawbufs.emplace_back(GL_COLOR_ATTACHMENT0 + i);
+                }
+            }
+
+            glDrawBuffers(drawbufs.size(), drawbufs.data());
+        }
+    }
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER, draw_fb);
+}
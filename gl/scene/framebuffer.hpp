@@ -18,6 +18,12 @@ namespace gl::scene
         draw
     };
 
+    enum class blit_filter
+    {
+        nearest,
+        linear
+    };
+
     class framebuffer
     {
     public:
@@ -34,11 +40,17 @@ namespace gl::scene
         framebuffer(scene& s, uint32_t i, uint32_t w, uint32_t h);
         ~framebuffer() = default;
 
-        void blit(uint32_t dst_width, uint32_t dst_height) const;
+        // blits to the surface framebuffer, 0 is the default one of the window.
+        void blit(uint32_t dst_width, uint32_t dst_height, uint32_t dst_handler = 0) const;
         void blit(const framebuffer& dst) const;
         void bind(framebuffer_target target = framebuffer_target::draw) const;
         void unbind() const;
         void resize(uint32_t w, uint32_t h);
+        // attaches the current textures of the attachments again, they must already have the new size.
+        void set_size(uint32_t w, uint32_t h);
+        // filter of blits to other sizes.
+        void set_blit_filter(blit_filter);
+        blit_filter get_blit_filter() const;
 
         void add_attachment(attachment_target, int32_t attachment_idx);
         void remove_attachment(attachment_target);
@@ -47,10 +59,12 @@ namespace gl::scene
 
     private:
         void clear(const std::function<gl::scene::pass_behaviour(const attachment&)>& f) const;
+        void attach(attachment_target target) const;
         scene& m_scene;
         uint32_t m_handler_idx;
         uint32_t m_width;
         uint32_t m_height;
         std::array<int32_t, max_attachments> m_attachments{-1, -1, -1, -1, -1};
+        blit_filter m_blit_filter{blit_filter::linear};
     };
 } // namespace gl::scene
@@ -2,6 +2,19 @@
 
 #include "material.hpp"
 
+#include <algorithm>
+
+namespace
+{
+    template<typename Container>
+    auto find_name(Container& c, gl::scene::name_id name)
+    {
+        return std::lower_bound(c.begin(), c.end(), name, [](const auto& l, gl::scene::name_id r) {
+            return l.name < r;
+        });
+    }
+} // namespace
+
 
 gl::scene::material::material(uint32_t shader_idx)
     : m_program(shader_idx)
@@ -23,7 +36,19 @@ const gl::scene::gpu_state& gl::scene::material::get_state() const
 
 void gl::scene::material::add_texture(const std::string& sampler, uint32_t i)
 {
-    m_textures.emplace(sampler, i);
+    add_texture(intern(sampler), i);
+}
+
+
+void gl::scene::material::add_texture(gl::scene::name_id sampler, uint32_t i)
+{
+    if (const auto it = find_name(m_textures, sampler); it != m_textures.end() && it->name == sampler) {
+        it->index = i;
+    } else {
+        m_textures.insert(it, named_index{sampler, i});
+    }
+
+    m_resolved = false;
 }
 
 
@@ -33,19 +58,126 @@ uint32_t gl::scene::material::get_program() const
 }
 
 
-const std::unordered_map<std::string, uint32_t>& gl::scene::material::get_textures() const
+void gl::scene::material::set_name(std::string name)
+{
+    m_name = std::move(name);
+}
+
+
+const std::string& gl::scene::material::get_name() const
+{
+    return m_name;
+}
+
+
+void gl::scene::material::set_animation(int32_t animation)
+{
+    m_animation = animation;
+}
+
+
+int32_t gl::scene::material::get_animation() const
+{
+    return m_animation;
+}
+
+
+const std::vector<gl::scene::material::named_index>& gl::scene::material::get_textures() const
 {
     return m_textures;
 }
 
 
-void gl::scene::material::add_parameter(std::string param_name, uint32_t param_idx)
+void gl::scene::material::add_parameter(const std::string& param_name, uint32_t param_idx)
 {
-    m_parameters.emplace(param_name, param_idx);
+    add_parameter(intern(param_name), param_idx);
 }
 
 
-const std::unordered_map<std::string, uint32_t>& gl::scene::material::get_parameters() const
+void gl::scene::material::add_parameter(gl::scene::name_id param_name, uint32_t param_idx)
+{
+    if (const auto it = find_name(m_parameters, param_name); it == m_parameters.end() || it->name != param_name) {
+        m_parameters.insert(it, named_index{param_name, param_idx});
+    }
+
+    m_resolved = false;
+}
+
+
+const std::vector<gl::scene::material::named_index>& gl::scene::material::get_parameters() const
 {
     return m_parameters;
 }
+
+
+int32_t gl::scene::material::find_texture(gl::scene::name_id name) const
+{
+    const auto it = find_name(m_textures, name);
+    return it != m_textures.end() && it->name == name ? int32_t(it->index) : -1;
+}
+
+
+int32_t gl::scene::material::find_parameter(gl::scene::name_id name) const
+{
+    const auto it = find_name(m_parameters, name);
+    return it != m_parameters.end() && it->name == name ? int32_t(it->index) : -1;
+}
+
+
+const std::vector<gl::scene::material::texture_binding>& gl::scene::material::get_texture_bindings(const gl::program& program) const
+{
+    resolve(program);
+    return m_texture_bindings;
+}
+
+
+const std::vector<gl::scene::material::parameter_binding>& gl::scene::material::get_parameter_bindings(const gl::program& program) const
+{
+    resolve(program);
+    return m_parameter_bindings;
+}
+
+
+const gl::scene::material::draw_data_binding& gl::scene::material::get_draw_data_binding(const gl::program& program) const
+{
+    resolve(program);
+    return m_draw_data_binding;
+}
+
+
+void gl::scene::material::resolve(const gl::program& program) const
+{
+    // the material is drawn with a fallback program while its own one is being built.
+    if (m_resolved && m_resolved_program == uint32_t(program)) {
+        return;
+    }
+
+    m_texture_bindings.clear();
+    m_parameter_bindings.clear();
+
+    // names are looked up in the program only here, bindings are used every draw.
+    for (const auto& [sampler, texture] : m_textures) {
+        if (const auto unit = program.get_texture_unit(gl::scene::get_name(sampler)); unit >= 0) {
+            m_texture_bindings.emplace_back(texture_binding{texture, unit});
+        }
+    }
+
+    for (const auto& [name, parameter] : m_parameters) {
+        if (const auto uniform = program.get_uniform(gl::scene::get_name(name)); uniform != nullptr) {
+            m_parameter_bindings.emplace_back(parameter_binding{parameter, uniform->location, uniform->block_binding, uniform->block_offset});
+        }
+    }
+
+    static const auto mvp = intern("u_MVP");
+    static const auto model = intern("u_MODEL");
+    static const auto anim_key = intern("u_ANIM_KEY");
+
+    m_draw_data_binding = {};
+
+    if (const auto unit = program.get_texture_unit("s_draw_data"); unit >= 0) {
+        m_draw_data_binding = {unit, find_parameter(mvp), find_parameter(model), find_parameter(anim_key)};
+    }
+
+    m_resolved = true;
+    m_resolved_program = program;
+}
@@ -4,9 +4,12 @@
 
 #include <gl_handlers.hpp>
 #include <gl/scene/pass.hpp>
+#include <gl/scene/name_id.hpp>
 
+#include <string>
 #include <variant>
 #include <unordered_map>
+#include <vector>
 
 
 namespace gl::scene
@@ -16,6 +19,38 @@ namespace gl::scene
     class material
     {
     public:
+        struct texture_binding
+        {
+            uint32_t texture;
+            int32_t unit;
+        };
+
+        struct parameter_binding
+        {
+            uint32_t parameter;
+            // default block location, -1 for uniform block members.
+            int32_t location;
+            int32_t block_binding;
+            int32_t block_offset;
+        };
+
+        // per draw parameters of programs fetching draw data from a vertex pool texture buffer.
+        // parameters are scene parameter indices, -1 when the material has no such parameter.
+        struct draw_data_binding
+        {
+            int32_t unit{-1};
+            int32_t mvp{-1};
+            int32_t model{-1};
+            int32_t anim_key{-1};
+        };
+
+        // scene texture or parameter index by name.
+        struct named_index
+        {
+            name_id name;
+            uint32_t index;
+        };
+
         explicit material(uint32_t program_idx);
         material(material&&) = default;
         material& operator=(material&&) = default;
@@ -26,15 +61,47 @@ namespace gl::scene
 
         uint32_t get_program() const;
 
+        // labels debug groups of the draws.
+        void set_name(std::string);
+        const std::string& get_name() const;
+
+        // scene animation whose clips the s_anim texture holds, -1 if the material is not skinned.
+        void set_animation(int32_t);
+        int32_t get_animation() const;
+
+        // a texture replaces the one of the same name, a parameter does not.
         void add_texture(const std::string&, uint32_t);
-        void add_parameter(std::string, uint32_t);
-        const std::unordered_map<std::string, uint32_t>& get_textures() const;
-        const std::unordered_map<std::string, uint32_t>& get_parameters() const;
+        void add_texture(name_id, uint32_t);
+        void add_parameter(const std::string&, uint32_t);
+        void add_parameter(name_id, uint32_t);
+        // sorted by name ids.
+        const std::vector<named_index>& get_textures() const;
+        const std::vector<named_index>& get_parameters() const;
+        // scene index of the texture or parameter, -1 if the material has none of the name.
+        int32_t find_texture(name_id) const;
+        int32_t find_parameter(name_id) const;
+
+        // textures and parameters resolved to the program units and locations,
+        // inactive ones are dropped. resolved again after textures or parameters or the program change.
+        const std::vector<texture_binding>& get_texture_bindings(const gl::program& program) const;
+        const std::vector<parameter_binding>& get_parameter_bindings(const gl::program& program) const;
+        // unit is -1 if the program does not sample draw data.
+        const draw_data_binding& get_draw_data_binding(const gl::program& program) const;
 
     private:
+        void resolve(const gl::program& program) const;
+
         uint32_t m_program;
-        std::unordered_map<std::string, uint32_t> m_textures;
-        std::unordered_map<std::string, uint32_t> m_parameters;
+        std::vector<named_index> m_textures;
+        std::vector<named_index> m_parameters;
         gl::scene::gpu_state m_state{};
+        std::string m_name;
+        int32_t m_animation{-1};
+
+        mutable bool m_resolved{false};
+        mutable uint32_t m_resolved_program{0};
+        mutable std::vector<texture_binding> m_texture_bindings;
+        mutable std::vector<parameter_binding> m_parameter_bindings;
+        mutable draw_data_binding m_draw_data_binding;
     };
 } // namespace gl::scene
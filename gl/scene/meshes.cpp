@@ -12,6 +12,45 @@ gl::scene::mesh::mesh(int32_t vsources_idx, indices_type it, uint32_t isz, uint3
 }
 
 
+gl::scene::mesh::mesh(
+    int32_t vsources_idx,
+    indices_type it,
+    uint32_t isz,
+    uint32_t vsz,
+    std::vector<vertex_region> vertex_regions,
+    index_region index_region)
+    : m_vertices(vsources_idx)
+    , m_indices_type(it)
+    , m_indices_size(isz)
+    , m_vertices_size(vsz)
+    , m_vertex_regions(std::move(vertex_regions))
+    , m_index_region(index_region)
+    , m_indices_offset(index_region.is_valid() ? index_region.offset : 0)
+{
+}
+
+
+gl::scene::mesh::mesh(
+    int32_t vsources_idx,
+    indices_type it,
+    uint32_t isz,
+    uint32_t vsz,
+    int32_t pool,
+    int32_t base_vertex,
+    uint32_t indices_offset,
+    uint32_t slot)
+    : m_vertices(vsources_idx)
+    , m_indices_type(it)
+    , m_indices_size(isz)
+    , m_vertices_size(vsz)
+    , m_pool(pool)
+    , m_base_vertex(base_vertex)
+    , m_indices_offset(indices_offset)
+    , m_pool_slot(slot)
+{
+}
+
+
 int32_t gl::scene::mesh::get_vertices() const
 {
     return m_vertices;
@@ -34,3 +73,63 @@ uint32_t gl::scene::mesh::get_vertices_size() const
 {
     return m_vertices_size;
 }
+
+
+uint32_t gl::scene::mesh::get_indices_offset() const
+{
+    return m_indices_offset;
+}
+
+
+const std::vector<gl::scene::mesh::vertex_region>& gl::scene::mesh::get_vertex_regions() const
+{
+    return m_vertex_regions;
+}
+
+
+const gl::scene::mesh::index_region& gl::scene::mesh::get_index_region() const
+{
+    return m_index_region;
+}
+
+
+int32_t gl::scene::mesh::get_pool() const
+{
+    return m_pool;
+}
+
+
+int32_t gl::scene::mesh::get_base_vertex() const
+{
+    return m_base_vertex;
+}
+
+
+uint32_t gl::scene::mesh::get_pool_slot() const
+{
+    return m_pool_slot;
+}
+
+
+void gl::scene::mesh::set_name(std::string name)
+{
+    m_name = std::move(name);
+}
+
+
+const std::string& gl::scene::mesh::get_name() const
+{
+    return m_name;
+}
+
+
+void gl::scene::mesh::set_bounds(const ::utils::aabb& bounds)
+{
+    m_bounds = bounds;
+}
+
+
+const ::utils::aabb& gl::scene::mesh::get_bounds() const
+{
+    return m_bounds;
+}
@@ -5,7 +5,12 @@
 #include <unordered_map>
 
 #include <gl/scene/material.hpp>
+#include <gl/buffer_arena.hpp>
 #include <gl_handlers.hpp>
+#include <bounds.hpp>
+
+#include <string>
+#include <vector>
 
 namespace gl::scene
 {
@@ -20,7 +25,14 @@ namespace gl::scene
             u32 = GL_UNSIGNED_INT,
         };
 
+        using vertex_region = gl::buffer_arena<GL_ARRAY_BUFFER>::region;
+        using index_region = gl::buffer_arena<GL_ELEMENT_ARRAY_BUFFER>::region;
+
         mesh(int32_t vsources_idx, indices_type ind_type, uint32_t ind_sz, uint32_t vert_sz);
+        // vertices and indices live in regions of the scene arenas, indices start at the index region offset.
+        mesh(int32_t vsources_idx, indices_type ind_type, uint32_t ind_sz, uint32_t vert_sz, std::vector<vertex_region> vertex_regions, index_region index_region);
+        // mesh appended to a vertex pool, vsources_idx is the pool vao.
+        mesh(int32_t vsources_idx, indices_type ind_type, uint32_t ind_sz, uint32_t vert_sz, int32_t pool, int32_t base_vertex, uint32_t indices_offset, uint32_t slot);
         mesh(mesh&&) = default;
         mesh& operator=(mesh&&) = default;
         ~mesh() = default;
@@ -28,11 +40,33 @@ namespace gl::scene
         indices_type get_indices_type() const;
         uint32_t get_indices_size() const;
         uint32_t get_vertices_size() const;
+        // byte offset of the first index in the bound element buffer.
+        uint32_t get_indices_offset() const;
+        const std::vector<vertex_region>& get_vertex_regions() const;
+        const index_region& get_index_region() const;
+        // -1 if the mesh does not live in a vertex pool.
+        int32_t get_pool() const;
+        int32_t get_base_vertex() const;
+        uint32_t get_pool_slot() const;
+        // labels debug groups of the draws.
+        void set_name(std::string);
+        const std::string& get_name() const;
+        // mesh space bounds, empty if unknown.
+        void set_bounds(const ::utils::aabb&);
+        const ::utils::aabb& get_bounds() const;
 
     private:
         int32_t m_vertices;
         indices_type m_indices_type;
         uint32_t m_indices_size;
         uint32_t m_vertices_size;
+        std::vector<vertex_region> m_vertex_regions;
+        index_region m_index_region;
+        int32_t m_pool{-1};
+        int32_t m_base_vertex{0};
+        uint32_t m_indices_offset{0};
+        uint32_t m_pool_slot{0};
+        std::string m_name;
+        ::utils::aabb m_bounds;
     };
 } // namespace gl::scene
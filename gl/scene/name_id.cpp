@@ -0,0 +1,47 @@
+
+
+#include "name_id.hpp"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace
+{
+    struct names_table
+    {
+        std::mutex mutex;
+        std::unordered_map<std::string, gl::scene::name_id> ids;
+        // deque keeps references of get_name valid.
+        std::deque<std::string> names;
+    };
+
+
+    names_table& get_table()
+    {
+        static names_table table;
+        return table;
+    }
+} // namespace
+
+
+gl::scene::name_id gl::scene::intern(const std::string& name)
+{
+    auto& table = get_table();
+    std::lock_guard lock(table.mutex);
+
+    if (const auto it = table.ids.find(name); it != table.ids.end()) {
+        return it->second;
+    }
+
+    table.names.emplace_back(name);
+    return table.ids.emplace(name, table.names.size() - 1).first->second;
+}
+
+
+const std::string& gl::scene::get_name(gl::scene::name_id id)
+{
+    auto& table = get_table();
+    std::lock_guard lock(table.mutex);
+    return table.names.at(id);
+}
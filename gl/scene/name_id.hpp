@@ -0,0 +1,16 @@
+
+
+#pragma once
+
+#include <cinttypes>
+#include <string>
+
+namespace gl::scene
+{
+    // interned names of parameters and textures, compared and sorted as integers.
+    using name_id = uint32_t;
+
+    // the same id for the same name for the whole run, thread safe.
+    name_id intern(const std::string& name);
+    const std::string& get_name(name_id id);
+} // namespace gl::scene
@@ -2,36 +2,35 @@
 
 #include "parameter.hpp"
 
+#include <stdexcept>
+
 
 gl::scene::parameter::parameter(
+    uint8_t* data,
     gl::scene::parameter_type param_type,
     gl::scene::parameter_component_type component_type)
-    : m_data(get_param_type_size(param_type) * get_param_components_size(component_type))
+    : m_data(data)
     , m_type(param_type)
     , m_component_type(component_type)
 {
 }
 
 
-gl::scene::parameter::parameter(
-    gl::scene::parameter_type param_type,
-    gl::scene::parameter_component_type component_type,
-    void* data)
-    : parameter(param_type, component_type)
+uint8_t* gl::scene::parameter::get_data()
 {
-    std::memcpy(m_data.data(), data, get_param_type_size(param_type) * get_param_components_size(component_type));
+    return m_data;
 }
 
 
-uint8_t* gl::scene::parameter::get_data()
+const uint8_t* gl::scene::parameter::get_data() const
 {
-    return m_data.data();
+    return m_data;
 }
 
 
-const uint8_t* gl::scene::parameter::get_data() const
+uint32_t gl::scene::parameter::get_size() const
 {
-    return m_data.data();
+    return get_param_type_size(m_type) * get_param_components_size(m_component_type);
 }
 
 
@@ -45,3 +44,57 @@ gl::scene::parameter_component_type gl::scene::parameter::get_component_type() c
 {
     return m_component_type;
 }
+
+
+uint32_t gl::scene::parameter_arena::emplace_back(
+    gl::scene::parameter_type param_type,
+    gl::scene::parameter_component_type component_type,
+    const void* data)
+{
+    const auto size = get_param_type_size(param_type) * get_param_components_size(component_type);
+    const auto blocks = (size + sizeof(block) - 1) / sizeof(block);
+
+    m_entries.emplace_back(entry{uint32_t(m_data.size()), param_type, component_type});
+    m_versions.emplace_back(0);
+    m_data.resize(m_data.size() + blocks, block{});
+
+    if (data != nullptr) {
+        std::memcpy(m_data[m_entries.back().offset].bytes, data, size);
+    }
+
+    return m_entries.size() - 1;
+}
+
+
+const gl::scene::parameter gl::scene::parameter_arena::at(uint32_t idx) const
+{
+    const auto& e = m_entries.at(idx);
+    // the view is const, the data is not written through it.
+    return parameter{const_cast<uint8_t*>(m_data[e.offset].bytes), e.type, e.component_type};
+}
+
+
+gl::scene::parameter gl::scene::parameter_arena::write(uint32_t idx)
+{
+    const auto& e = m_entries.at(idx);
+    ++m_versions[idx];
+    return parameter{m_data[e.offset].bytes, e.type, e.component_type};
+}
+
+
+size_t gl::scene::parameter_arena::size() const
+{
+    return m_entries.size();
+}
+
+
+size_t gl::scene::parameter_arena::get_bytes() const
+{
+    return m_data.size() * sizeof(block);
+}
+
+
+const uint32_t& gl::scene::parameter_arena::get_version(uint32_t idx) const
+{
+    return m_versions.at(idx);
+}
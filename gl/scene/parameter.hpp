@@ -2,6 +2,7 @@
 
 #pragma once
 
+#include <cassert>
 #include <cinttypes>
 #include <cstring>
 #include <vector>
@@ -45,21 +46,86 @@ namespace gl::scene
     }
 
 
+    // view of a parameter in a parameter_arena.
     class parameter
     {
     public:
-        parameter(parameter_type, parameter_component_type);
-        parameter(parameter_type, parameter_component_type, void* data);
+        parameter(uint8_t* data, parameter_type, parameter_component_type);
         ~parameter() = default;
 
         uint8_t* get_data();
         const uint8_t* get_data() const;
+        uint32_t get_size() const;
         parameter_type get_param_type() const;
         parameter_component_type get_component_type() const;
 
     private:
-        std::vector<uint8_t> m_data;
+        uint8_t* m_data;
         parameter_type m_type;
         parameter_component_type m_component_type;
     };
+
+
+    // data of all parameters in one allocation, every parameter aligned to 16 bytes.
+    // parameters are addressed by their indices, data pointers are valid until the next emplace_back.
+    // every parameter has a version which changes when it is written, uniforms of unchanged versions are not uploaded.
+    class parameter_arena
+    {
+    public:
+        parameter_arena() = default;
+        ~parameter_arena() = default;
+
+        // data is zeroed if there is no data to copy.
+        uint32_t emplace_back(parameter_type, parameter_component_type, const void* data = nullptr);
+
+        const parameter at(uint32_t) const;
+        // view to write the data through, it changes the version.
+        parameter write(uint32_t);
+        size_t size() const;
+        // bytes of all parameters, alignment included.
+        size_t get_bytes() const;
+        const uint32_t& get_version(uint32_t) const;
+
+        template<typename T>
+        const T& get(uint32_t idx) const
+        {
+            assert(at(idx).get_size() == sizeof(T));
+            return *reinterpret_cast<const T*>(at(idx).get_data());
+        }
+
+        // changes the version only if the value is different, returns true then.
+        template<typename T>
+        bool set(uint32_t idx, const T& value)
+        {
+            const auto& e = m_entries.at(idx);
+            auto* data = m_data[e.offset].bytes;
+
+            assert(get_param_type_size(e.type) * get_param_components_size(e.component_type) == sizeof(T));
+
+            if (std::memcmp(data, &value, sizeof(T)) == 0) {
+                return false;
+            }
+
+            std::memcpy(data, &value, sizeof(T));
+            ++m_versions[idx];
+            return true;
+        }
+
+    private:
+        struct alignas(16) block
+        {
+            uint8_t bytes[16];
+        };
+
+        struct entry
+        {
+            uint32_t offset;
+            parameter_type type;
+            parameter_component_type component_type;
+        };
+
+        std::vector<block> m_data;
+        std::vector<entry> m_entries;
+        std::vector<uint32_t> m_versions;
+    };
 } // namespace gl::scene
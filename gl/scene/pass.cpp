@@ -28,43 +28,41 @@ void gl::scene::pass::unbind() const
 
 void gl::scene::pass::set_state(const gl::scene::gpu_state& new_state) const
 {
+    auto& state = m_scene.state;
+
     switch (new_state.depth_func) {
         case depth_func::off:
-            glDisable(GL_DEPTH_TEST);
+            state.set_depth_test(false);
             break;
         case depth_func::less:
-            glEnable(GL_DEPTH_TEST);
-            glDepthFunc(GL_LESS);
+            state.set_depth_test(true);
+            state.set_depth_func(GL_LESS);
             break;
         case depth_func::leq:
-            glEnable(GL_DEPTH_TEST);
-            glDepthFunc(GL_LEQUAL);
+            state.set_depth_test(true);
+            state.set_depth_func(GL_LEQUAL);
             break;
         case depth_func::eq:
-            glEnable(GL_DEPTH_TEST);
-            glDepthFunc(GL_EQUAL);
+            state.set_depth_test(true);
+            state.set_depth_func(GL_EQUAL);
             break;
     }
 
-    glDepthMask(new_state.depth_write ? GL_TRUE : GL_FALSE);
+    state.set_depth_write(new_state.depth_write);
 
-    glColorMask(
-        new_state.color_write[0] ? GL_TRUE : GL_FALSE,
-        new_state.color_write[1] ? GL_TRUE : GL_FALSE,
-        new_state.color_write[2] ? GL_TRUE : GL_FALSE,
-        new_state.color_write[3] ? GL_TRUE : GL_FALSE);
+    state.set_color_mask(new_state.color_write[0], new_state.color_write[1], new_state.color_write[2], new_state.color_write[3]);
 
     switch (new_state.culling) {
         case cull_func::front:
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_FRONT);
+            state.set_cull_face(true);
+            state.set_cull_mode(GL_FRONT);
             break;
         case cull_func::back:
-            glEnable(GL_CULL_FACE);
-            glCullFace(GL_BACK);
+            state.set_cull_face(true);
+            state.set_cull_mode(GL_BACK);
             break;
         case cull_func::off:
-            glDisable(GL_CULL_FACE);
+            state.set_cull_face(false);
             break;
     }
 }
@@ -78,10 +76,12 @@ uint32_t gl::scene::pass::get_framebuffer_idx() const
 
 void gl::scene::pass::reset() const
 {
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_TRUE);
-    glDepthFunc(GL_LESS);
-    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
-    glCullFace(GL_BACK);
-    glDisable(GL_CULL_FACE);
+    auto& state = m_scene.state;
+
+    state.set_depth_test(false);
+    state.set_depth_write(true);
+    state.set_depth_func(GL_LESS);
+    state.set_color_mask(true, true, true, true);
+    state.set_cull_mode(GL_BACK);
+    state.set_cull_face(false);
 }
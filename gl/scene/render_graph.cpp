@@ -0,0 +1,293 @@
+
+
+#include "render_graph.hpp"
+
+#include <gl/profiler.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <stdexcept>
+
+
+uint32_t gl::scene::render_graph::create_attachment(std::string name, gl::scene::render_graph::attachment_desc desc)
+{
+    m_resources.emplace_back(resource{std::move(name), desc});
+    return m_resources.size() - 1;
+}
+
+
+uint32_t gl::scene::render_graph::add_pass(gl::scene::render_graph::pass_desc desc)
+{
+    if (desc.color_writes.size() > framebuffer::depth) {
+        throw std::runtime_error("too many color attachments in pass " + desc.name);
+    }
+
+    for (const auto r : desc.reads) {
+        if (std::find(desc.color_writes.begin(), desc.color_writes.end(), r) != desc.color_writes.end() || int32_t(r) == desc.depth_write) {
+            throw std::runtime_error("pass " + desc.name + " reads an attachment it writes, blit it into another one first.");
+        }
+    }
+
+    m_nodes.emplace_back(node{std::move(desc)});
+    return m_nodes.size() - 1;
+}
+
+
+uint32_t gl::scene::render_graph::add_blit(std::string name, uint32_t src, uint32_t dst)
+{
+    assert(src < m_resources.size() && dst < m_resources.size());
+
+    if (m_resources[src].desc.type == attachment_type::depth24f || m_resources[dst].desc.type == attachment_type::depth24f) {
+        throw std::runtime_error("only color attachments can be blitted, pass " + name);
+    }
+
+    pass_desc desc;
+    desc.name = std::move(name);
+    desc.reads = {src};
+    desc.color_writes = {dst};
+
+    m_nodes.emplace_back(node{std::move(desc), int32_t(src)});
+    return m_nodes.size() - 1;
+}
+
+
+void gl::scene::render_graph::set_output(uint32_t attachment)
+{
+    assert(attachment < m_resources.size());
+    m_output = attachment;
+}
+
+
+void gl::scene::render_graph::compile(gl::scene::scene& s)
+{
+    // pass culling and aliasing.
+    gl::cpu_zone zone("render_graph::compile");
+
+    if (m_output < 0) {
+        throw std::runtime_error("render graph has no output.");
+    }
+
+    // every node depends on the last previous writer of the attachments it reads or writes.
+    std::vector<std::vector<uint32_t>> dependencies(m_nodes.size());
+    std::vector<int32_t> last_writer(m_resources.size(), -1);
+
+    auto for_each_write = [](const pass_desc& desc, auto&& f) {
+        std::for_each(desc.color_writes.begin(), desc.color_writes.end(), f);
+        if (desc.depth_write >= 0) {
+            f(uint32_t(desc.depth_write));
+        }
+    };
+
+    for (uint32_t i = 0; i < m_nodes.size(); ++i) {
+        const auto& desc = m_nodes[i].desc;
+
+        auto depend = [&](uint32_t r) {
+            assert(r < m_resources.size());
+            if (last_writer[r] >= 0) {
+                dependencies[i].emplace_back(last_writer[r]);
+            }
+        };
+
+        std::for_each(desc.reads.begin(), desc.reads.end(), depend);
+        for_each_write(desc, depend);
+
+        for_each_write(desc, [&](uint32_t r) {
+            last_writer[r] = i;
+        });
+    }
+
+    if (last_writer[m_output] < 0) {
+        throw std::runtime_error("render graph output " + m_resources[m_output].name + " is never written.");
+    }
+
+    // dependencies point backwards, one reverse walk marks everything the output and side effects need.
+    std::vector<bool> live(m_nodes.size(), false);
+    live[last_writer[m_output]] = true;
+
+    for (int32_t i = int32_t(m_nodes.size()) - 1; i >= 0; --i) {
+        live[i] = live[i] || m_nodes[i].desc.has_side_effects;
+
+        if (live[i]) {
+            for (const auto dependency : dependencies[i]) {
+                live[dependency] = true;
+            }
+        }
+    }
+
+    std::vector<uint32_t> order;
+
+    for (uint32_t i = 0; i < m_nodes.size(); ++i) {
+        m_nodes[i].culled = !live[i];
+        if (live[i]) {
+            order.emplace_back(i);
+        }
+    }
+
+    // lifetimes in the live order, the output lives until the present.
+    constexpr auto unused = std::numeric_limits<uint32_t>::max();
+    std::vector<uint32_t> first_use(m_resources.size(), unused);
+    std::vector<uint32_t> last_use(m_resources.size(), 0);
+
+    for (uint32_t step = 0; step < order.size(); ++step) {
+        const auto& desc = m_nodes[order[step]].desc;
+
+        auto use = [&](uint32_t r) {
+            first_use[r] = std::min(first_use[r], step);
+            last_use[r] = std::max(last_use[r], step);
+        };
+
+        std::for_each(desc.reads.begin(), desc.reads.end(), use);
+        for_each_write(desc, use);
+    }
+
+    last_use[m_output] = unused;
+
+    // attachments of the present framebuffer get textures of their own, resolution_controller resizes them
+    // by swapping the textures, which must not change the storage of an earlier pass.
+    std::vector<bool> dedicated(m_resources.size(), false);
+    dedicated[m_output] = true;
+
+    if (const auto& last = m_nodes[order.back()]; last.blit_src < 0 && !last.desc.color_writes.empty() && last.desc.color_writes.front() == uint32_t(m_output)) {
+        for_each_write(last.desc, [&dedicated](uint32_t r) {
+            dedicated[r] = true;
+        });
+    }
+
+    // greedy placement by first use into a texture of the same type and size which is free by then.
+    struct texture_slot
+    {
+        attachment_desc desc;
+        uint32_t texture;
+        uint32_t busy_until;
+    };
+
+    std::vector<texture_slot> textures;
+    std::vector<uint32_t> by_first_use(m_resources.size());
+    std::iota(by_first_use.begin(), by_first_use.end(), 0);
+    std::stable_sort(by_first_use.begin(), by_first_use.end(), [&first_use](uint32_t l, uint32_t r) {
+        return first_use[l] < first_use[r];
+    });
+
+    for (const auto r : by_first_use) {
+        auto& res = m_resources[r];
+        res.texture = -1;
+
+        if (first_use[r] == unused) {
+            continue;
+        }
+
+        auto slot = dedicated[r] ? textures.end() : std::find_if(textures.begin(), textures.end(), [&](const texture_slot& t) {
+            return t.desc.type == res.desc.type && t.desc.width == res.desc.width && t.desc.height == res.desc.height && t.busy_until < first_use[r];
+        });
+
+        if (slot == textures.end()) {
+            s.textures.emplace_back(gl::texture<GL_TEXTURE_2D>{});
+            slot = textures.insert(textures.end(), texture_slot{res.desc, uint32_t(s.textures.size() - 1), 0});
+        }
+
+        slot->busy_until = last_use[r];
+        res.texture = slot->texture;
+    }
+
+    m_textures_count = textures.size();
+
+    // the first live pass writing an attachment clears it.
+    std::vector<bool> written(m_resources.size(), false);
+    int32_t last_pass = -1;
+    bool output_bound = false;
+
+    for (const auto i : order) {
+        const auto& n = m_nodes[i];
+
+        if (n.blit_src >= 0) {
+            const auto dst = n.desc.color_writes.front();
+            const auto src_pass = make_pass(s, {uint32_t(n.blit_src)}, -1, {false});
+            const auto dst_pass = make_pass(s, {dst}, -1, {false});
+
+            s.commands.emplace_back(render_command{render_command::type::blit, src_pass, dst_pass});
+            written[dst] = true;
+            output_bound = false;
+            continue;
+        }
+
+        std::vector<bool> clear;
+
+        for_each_write(n.desc, [&](uint32_t r) {
+            clear.emplace_back(!written[r]);
+            written[r] = true;
+        });
+
+        last_pass = make_pass(s, n.desc.color_writes, n.desc.depth_write, clear);
+        output_bound = !n.desc.color_writes.empty() && n.desc.color_writes.front() == uint32_t(m_output);
+
+        s.commands.emplace_back(render_command{render_command::type::pass, uint32_t(last_pass)});
+
+        for (const auto drawable : n.desc.drawables) {
+            s.commands.emplace_back(render_command{render_command::type::draw, drawable});
+        }
+    }
+
+    // the surface blit reads the first color attachment of the last bound pass.
+    if (last_pass < 0 || !output_bound) {
+        const auto present_pass = make_pass(s, {uint32_t(m_output)}, -1, {false});
+        s.commands.emplace_back(render_command{render_command::type::pass, present_pass});
+    }
+}
+
+
+bool gl::scene::render_graph::is_culled(uint32_t pass) const
+{
+    return m_nodes.at(pass).culled;
+}
+
+
+int32_t gl::scene::render_graph::get_texture(uint32_t attachment) const
+{
+    return m_resources.at(attachment).texture;
+}
+
+
+uint32_t gl::scene::render_graph::get_textures_count() const
+{
+    return m_textures_count;
+}
+
+
+uint32_t gl::scene::render_graph::make_pass(
+    gl::scene::scene& s,
+    const std::vector<uint32_t>& color,
+    int32_t depth,
+    const std::vector<bool>& clear) const
+{
+    const auto& size_desc = m_resources.at(color.empty() ? uint32_t(depth) : color.front()).desc;
+
+    s.fbos.emplace_back();
+    auto& fb = s.framebuffers.emplace_back(s, s.fbos.size() - 1, size_desc.width, size_desc.height);
+
+    auto attach = [&](framebuffer::attachment_target target, uint32_t r, bool clear_on_start) {
+        const auto& res = m_resources.at(r);
+
+        if (res.desc.width != size_desc.width || res.desc.height != size_desc.height) {
+            throw std::runtime_error("attachments of a pass differ in size, " + res.name);
+        }
+
+        auto& a = s.attachments.emplace_back(s, res.texture, res.desc.type);
+        a.set_clear_values(res.desc.clear_values.data());
+        a.set_start_pass_behaviour(clear_on_start ? pass_behaviour::clear : pass_behaviour::save);
+        a.set_end_pass_behaviour(pass_behaviour::save);
+
+        fb.add_attachment(target, s.attachments.size() - 1);
+    };
+
+    for (uint32_t i = 0; i < color.size(); ++i) {
+        attach(framebuffer::attachment_target(framebuffer::color1 + i), color[i], clear.at(i));
+    }
+
+    if (depth >= 0) {
+        attach(framebuffer::depth, depth, clear.at(color.size()));
+    }
+
+    s.passes.emplace_back(s, s.framebuffers.size() - 1);
+    return s.passes.size() - 1;
+}
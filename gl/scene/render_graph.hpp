@@ -0,0 +1,84 @@
+
+
+#pragma once
+
+#include <gl/scene/scene.hpp>
+
+#include <array>
+#include <string>
+#include <vector>
+
+namespace gl::scene
+{
+    // passes declare the attachments they read and write. compile runs them in declaration order,
+    // drops the passes neither the output nor a pass with side effects depends on, places attachments
+    // with non overlapping lifetimes into shared textures and writes framebuffers, passes and commands into the scene.
+    // the output is blitted to the surface by the last pass, a present pass is added if it does not write the output.
+    // attachments of that pass are never shared, so the present framebuffer can be resized on its own.
+    class render_graph
+    {
+    public:
+        struct attachment_desc
+        {
+            attachment_type type;
+            uint32_t width;
+            uint32_t height;
+            std::array<float, 4> clear_values{1, 1, 1, 1};
+        };
+
+        struct pass_desc
+        {
+            std::string name;
+            // attachments sampled by the pass drawables.
+            std::vector<uint32_t> reads;
+            // up to 4 color attachments and an optional depth one, all of one size.
+            // cleared by the first pass writing them, kept by the later ones.
+            std::vector<uint32_t> color_writes;
+            int32_t depth_write{-1};
+            std::vector<uint32_t> drawables;
+            // kept even if nothing depends on its outputs.
+            bool has_side_effects{false};
+        };
+
+        render_graph() = default;
+        ~render_graph() = default;
+
+        uint32_t create_attachment(std::string name, attachment_desc desc);
+        uint32_t add_pass(pass_desc desc);
+        // copies color of src into dst, sizes may differ.
+        uint32_t add_blit(std::string name, uint32_t src, uint32_t dst);
+        void set_output(uint32_t attachment);
+
+        void compile(scene& s);
+
+        bool is_culled(uint32_t pass) const;
+        // scene texture index of the attachment, -1 if no live pass uses it. valid after compile.
+        int32_t get_texture(uint32_t attachment) const;
+        // textures the attachments were placed into.
+        uint32_t get_textures_count() const;
+
+    private:
+        struct resource
+        {
+            std::string name;
+            attachment_desc desc;
+            int32_t texture{-1};
+        };
+
+        struct node
+        {
+            pass_desc desc;
+            // source attachment of a blit node, it writes its only color write.
+            int32_t blit_src{-1};
+            bool culled{false};
+        };
+
+        // scene pass with a framebuffer of the attachments, clear has a flag per color attachment and then depth.
+        uint32_t make_pass(scene& s, const std::vector<uint32_t>& color, int32_t depth, const std::vector<bool>& clear) const;
+
+        std::vector<resource> m_resources;
+        std::vector<node> m_nodes;
+        int32_t m_output{-1};
+        uint32_t m_textures_count{0};
+    };
+} // namespace gl::scene
@@ -0,0 +1,209 @@
+
+
+#include "render_queue.hpp"
+
+#include <gl/profiler.hpp>
+
+#include <algorithm>
+#include <array>
+
+
+namespace
+{
+    uint64_t field(uint64_t value, uint32_t bits, uint32_t shift)
+    {
+        return (value & ((uint64_t(1) << bits) - 1)) << shift;
+    }
+} // namespace
+
+
+gl::scene::render_queue::render_queue(const gl::scene::scene& s)
+    : m_scene(s)
+{
+}
+
+
+void gl::scene::render_queue::clear()
+{
+    m_items.clear();
+    m_segments.clear();
+}
+
+
+void gl::scene::render_queue::set_depth_range(float near, float far)
+{
+    assert(far > near);
+    m_near = near;
+    m_far = far;
+}
+
+
+void gl::scene::render_queue::push(uint32_t pass, uint32_t drawable, float view_depth)
+{
+    m_items.emplace_back(item{make_key(pass, drawable, view_depth), pass, drawable});
+}
+
+
+void gl::scene::render_queue::push_commands(
+    const std::vector<gl::scene::render_command>& commands,
+    const std::function<float(uint32_t)>& get_view_depth,
+    const std::function<bool(uint32_t)>& is_visible)
+{
+    gl::cpu_zone zone("render_queue::push_commands");
+    uint32_t curr_pass = 0;
+
+    for (const auto& command : commands) {
+        switch (command.type) {
+            case render_command::type::pass:
+                curr_pass = command.source_index;
+                m_segments.emplace_back(segment{command, get_size()});
+                break;
+            case render_command::type::draw:
+                if (!is_visible || is_visible(command.source_index)) {
+                    push(curr_pass, command.source_index, get_view_depth(command.source_index));
+                }
+                break;
+            default:
+                m_segments.emplace_back(segment{command, get_size()});
+                break;
+        }
+    }
+}
+
+
+void gl::scene::render_queue::sort()
+{
+    gl::cpu_zone zone("render_queue::sort");
+
+    uint32_t first_item = 0;
+
+    for (const auto& curr_segment : m_segments) {
+        sort(first_item, curr_segment.first_item);
+        first_item = curr_segment.first_item;
+    }
+
+    sort(first_item, get_size());
+}
+
+
+void gl::scene::render_queue::make_commands(std::vector<gl::scene::render_command>& commands) const
+{
+    int64_t curr_pass = -1;
+    uint32_t curr_item = 0;
+
+    const auto push_items = [&](uint32_t last_item) {
+        for (; curr_item < last_item; ++curr_item) {
+            const auto& pushed = m_items[curr_item];
+
+            if (curr_pass != pushed.pass) {
+                curr_pass = pushed.pass;
+                commands.emplace_back(render_command{render_command::type::pass, pushed.pass});
+            }
+
+            commands.emplace_back(render_command{render_command::type::draw, pushed.drawable});
+        }
+    };
+
+    for (const auto& curr_segment : m_segments) {
+        push_items(curr_segment.first_item);
+        commands.emplace_back(curr_segment.command);
+
+        if (curr_segment.command.type == render_command::type::pass) {
+            curr_pass = curr_segment.command.source_index;
+        }
+    }
+
+    push_items(get_size());
+}
+
+
+uint32_t gl::scene::render_queue::get_size() const
+{
+    return m_items.size();
+}
+
+
+gl::scene::render_queue::bucket gl::scene::render_queue::get_bucket(uint32_t drawable) const
+{
+    const auto& curr_drawable = m_scene.drawables.at(drawable);
+
+    if (m_scene.materials.at(curr_drawable.material_idx).get_state().blend != blend_func::off) {
+        return bucket::transparent;
+    }
+
+    return curr_drawable.background ? bucket::background : bucket::opaque;
+}
+
+
+uint64_t gl::scene::render_queue::make_key(uint32_t pass, uint32_t drawable, float view_depth) const
+{
+    const auto& curr_drawable = m_scene.drawables.at(drawable);
+    const auto& mat = m_scene.materials.at(curr_drawable.material_idx);
+    const uint64_t program = mat.get_program();
+    const uint64_t material = curr_drawable.material_idx;
+    const uint64_t vertices = m_scene.meshes.at(curr_drawable.mesh_idx).get_vertices();
+    const auto curr_bucket = get_bucket(drawable);
+
+    const float depth = std::clamp((view_depth - m_near) / (m_far - m_near), 0.f, 1.f);
+
+    uint64_t key = field(pass, 8, 56) | field(uint64_t(curr_bucket), 2, 54);
+
+    if (curr_bucket == bucket::transparent) {
+        const auto depth_bits = uint64_t((1.f - depth) * float((1 << 24) - 1));
+        key |= field(depth_bits, 24, 30) | field(program, 12, 18) | field(material, 18, 0);
+    } else {
+        const auto depth_bits = uint64_t(depth * float((1 << 16) - 1));
+        key |= field(program, 12, 42) | field(material, 14, 28) | field(vertices, 12, 16) | field(depth_bits, 16, 0);
+    }
+
+    return key;
+}
+
+
+void gl::scene::render_queue::sort(uint32_t first_item, uint32_t last_item)
+{
+    if (last_item - first_item < 2) {
+        return;
+    }
+
+    const auto items = m_items.begin() + first_item;
+    const uint32_t items_count = last_item - first_item;
+
+    m_sort_buffer.resize(items_count);
+    // radix passes ping pong between the range and the buffer, odd passes leave the result in the buffer.
+    bool in_buffer = false;
+
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        item* src = in_buffer ? m_sort_buffer.data() : &*items;
+        item* dst = in_buffer ? &*items : m_sort_buffer.data();
+
+        std::array<uint32_t, 256> offsets{};
+
+        for (uint32_t i = 0; i < items_count; ++i) {
+            ++offsets[(src[i].key >> shift) & 0xFF];
+        }
+
+        // every key has the same byte, the pass would not reorder anything.
+        if (offsets[(src[0].key >> shift) & 0xFF] == items_count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+
+        for (auto& bucket_offset : offsets) {
+            const auto count = bucket_offset;
+            bucket_offset = offset;
+            offset += count;
+        }
+
+        for (uint32_t i = 0; i < items_count; ++i) {
+            dst[offsets[(src[i].key >> shift) & 0xFF]++] = src[i];
+        }
+
+        in_buffer = !in_buffer;
+    }
+
+    if (in_buffer) {
+        std::copy(m_sort_buffer.begin(), m_sort_buffer.end(), items);
+    }
+}
@@ -0,0 +1,75 @@
+
+
+
+#pragma once
+
+#include <gl/scene/scene.hpp>
+
+#include <functional>
+#include <vector>
+
+namespace gl::scene
+{
+    // per frame draw list ordered by 64 bit sort keys.
+    // key, from the most significant bits: pass (8), bucket (2), then
+    // opaque and background: program (12), material (14), vertex source (12), view depth front to back (16),
+    // transparent: view depth back to front (24), program (12), material (18).
+    class render_queue
+    {
+    public:
+        enum class bucket : uint8_t
+        {
+            opaque,
+            // skybox like drawables, go after opaques so early depth test rejects covered pixels.
+            background,
+            transparent
+        };
+
+        explicit render_queue(const scene& s);
+        ~render_queue() = default;
+
+        void clear();
+        // view depth is quantized over the depth range, depths outside of it are clamped.
+        void set_depth_range(float near, float far);
+        void push(uint32_t pass, uint32_t drawable, float view_depth);
+        // pushes draw commands, pass and blit commands are kept in place and split the draws into segments.
+        // draws of drawables is_visible returns false for are skipped.
+        void push_commands(
+            const std::vector<render_command>& commands,
+            const std::function<float(uint32_t)>& get_view_depth,
+            const std::function<bool(uint32_t)>& is_visible = {});
+        // lsd radix sort of every segment, byte passes where all keys are equal are skipped.
+        // draws never move across pass and blit commands.
+        void sort();
+        // segment commands in push order, pass command whenever the pass of the draws changes.
+        void make_commands(std::vector<render_command>& commands) const;
+
+        uint32_t get_size() const;
+        bucket get_bucket(uint32_t drawable) const;
+        uint64_t make_key(uint32_t pass, uint32_t drawable, float view_depth) const;
+
+    private:
+        struct item
+        {
+            uint64_t key;
+            uint32_t pass;
+            uint32_t drawable;
+        };
+
+        // pass or blit command followed by the draws starting at first_item.
+        struct segment
+        {
+            render_command command;
+            uint32_t first_item;
+        };
+
+        void sort(uint32_t first_item, uint32_t last_item);
+
+        const scene& m_scene;
+        float m_near{0.1f};
+        float m_far{100.f};
+        std::vector<item> m_items;
+        std::vector<item> m_sort_buffer;
+        std::vector<segment> m_segments;
+    };
+} // namespace gl::scene
@@ -0,0 +1,172 @@
+
+
+#include "resolution_controller.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+
+gl::scene::resolution_controller::resolution_controller(gl::scene::scene& s, uint32_t framebuffer_idx, gl::scene::resolution_settings settings)
+    : m_scene(s)
+    , m_framebuffer_idx(framebuffer_idx)
+    , m_settings(settings)
+    , m_step(settings.steps - 1)
+{
+    assert(m_settings.steps > 0);
+    assert(m_settings.min_scale > 0 && m_settings.min_scale <= m_settings.max_scale);
+
+    auto& fb = m_scene.framebuffers.at(m_framebuffer_idx);
+    fb.set_blit_filter(m_settings.filter);
+    m_render_size = fb.get_size();
+}
+
+
+void gl::scene::resolution_controller::begin_frame()
+{
+    const auto now = std::chrono::steady_clock::now();
+
+    if (m_frame_start != std::chrono::steady_clock::time_point{}) {
+        m_cpu_frame_ms = std::chrono::duration<double, std::milli>(now - m_frame_start).count();
+    }
+
+    m_frame_start = now;
+    m_timer.begin();
+}
+
+
+void gl::scene::resolution_controller::end_frame()
+{
+    m_timer.end();
+}
+
+
+bool gl::scene::resolution_controller::update(uint32_t surface_width, uint32_t surface_height)
+{
+    double gpu_frame_ms;
+    std::optional<double> sample;
+
+    // once the gpu time is known it is the only input, cpu time also has vsync waits in it.
+    if (m_timer.poll(gpu_frame_ms)) {
+        m_has_gpu_time = true;
+        sample = gpu_frame_ms;
+    } else if (!m_has_gpu_time && m_cpu_frame_ms > 0) {
+        sample = m_cpu_frame_ms;
+    }
+
+    if (sample) {
+        m_frame_ms = m_has_frame_ms ? m_frame_ms + (float(*sample) - m_frame_ms) * m_settings.smoothing : float(*sample);
+        m_has_frame_ms = true;
+
+        if (m_frame_ms > m_settings.target_frame_ms * m_settings.upper_threshold) {
+            ++m_frames_over;
+            m_frames_under = 0;
+        } else if (m_frame_ms < m_settings.target_frame_ms * m_settings.lower_threshold) {
+            ++m_frames_under;
+            m_frames_over = 0;
+        } else {
+            m_frames_over = 0;
+            m_frames_under = 0;
+        }
+
+        if (m_frames_over >= m_settings.frames_to_decrease && m_step > 0) {
+            --m_step;
+            m_frames_over = 0;
+        } else if (m_frames_under >= m_settings.frames_to_increase && m_step + 1 < m_settings.steps) {
+            ++m_step;
+            m_frames_under = 0;
+        }
+    }
+
+    const size surface_size{surface_width, surface_height};
+
+    // textures of the old surface sizes are not going to be used again.
+    if (surface_size != m_surface_size) {
+        m_surface_size = surface_size;
+        m_textures.clear();
+    }
+
+    const auto scale = get_scale();
+    const size render_size{
+        std::max(1u, uint32_t(std::lround(surface_width * scale))),
+        std::max(1u, uint32_t(std::lround(surface_height * scale)))};
+
+    if (render_size == m_render_size) {
+        return false;
+    }
+
+    apply_size(render_size);
+    return true;
+}
+
+
+float gl::scene::resolution_controller::get_scale() const
+{
+    return get_step_scale(m_step);
+}
+
+
+float gl::scene::resolution_controller::get_frame_ms() const
+{
+    return m_frame_ms;
+}
+
+
+std::pair<uint32_t, uint32_t> gl::scene::resolution_controller::get_render_size() const
+{
+    return m_render_size;
+}
+
+
+float gl::scene::resolution_controller::get_step_scale(uint32_t step) const
+{
+    if (m_settings.steps == 1) {
+        return m_settings.max_scale;
+    }
+
+    const auto t = float(step) / float(m_settings.steps - 1);
+    return m_settings.min_scale + (m_settings.max_scale - m_settings.min_scale) * t;
+}
+
+
+void gl::scene::resolution_controller::apply_size(gl::scene::resolution_controller::size render_size)
+{
+    auto& fb = m_scene.framebuffers.at(m_framebuffer_idx);
+
+    std::vector<uint32_t> attachments;
+
+    for (size_t i = 0; i < framebuffer::max_attachments; ++i) {
+        if (const auto attachment = fb.get_attachment(framebuffer::attachment_target(i)); attachment >= 0) {
+            attachments.emplace_back(attachment);
+        }
+    }
+
+    // current textures go to the pool, the ones of the new size come from it or are allocated once.
+    auto& current = m_textures[m_render_size];
+    current.clear();
+
+    for (const auto attachment : attachments) {
+        current.emplace_back(std::move(m_scene.textures.at(m_scene.attachments.at(attachment).get_handler_idx())));
+    }
+
+    auto pooled = m_textures.find(render_size);
+
+    for (size_t i = 0; i < attachments.size(); ++i) {
+        const auto& attachment = m_scene.attachments.at(attachments[i]);
+        auto& texture = m_scene.textures.at(attachment.get_handler_idx());
+
+        if (pooled != m_textures.end()) {
+            texture = std::move(pooled->second.at(i));
+        } else {
+            texture = gl::texture<GL_TEXTURE_2D>{};
+            attachment.resize(render_size.first, render_size.second);
+        }
+    }
+
+    if (pooled != m_textures.end()) {
+        m_textures.erase(pooled);
+    }
+
+    fb.set_size(render_size.first, render_size.second);
+    m_render_size = render_size;
+}
@@ -0,0 +1,83 @@
+
+
+#pragma once
+
+#include <gl/gpu_timer.hpp>
+#include <gl/scene/scene.hpp>
+
+#include <chrono>
+#include <map>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace gl::scene
+{
+    struct resolution_settings
+    {
+        float target_frame_ms = 1000.f / 60.f;
+        float min_scale = 0.5f;
+        float max_scale = 1.f;
+        // scales from min to max, the render size only takes these.
+        uint32_t steps = 5;
+        // band around the target, as fractions of it, where the scale does not change.
+        float lower_threshold = 0.8f;
+        float upper_threshold = 1.05f;
+        // frames out of the band before a step, going up is slower so the scale does not oscillate.
+        uint32_t frames_to_decrease = 3;
+        uint32_t frames_to_increase = 30;
+        // weight of the newest frame time.
+        float smoothing = 0.1f;
+        blit_filter filter = blit_filter::linear;
+    };
+
+    // scales the render size of a framebuffer to keep the frame time near a target.
+    // frame time is the gpu time of the frame when a timer result is available and the cpu time otherwise,
+    // smoothed, and the scale moves one quantized step after it stays out of the hysteresis band for some frames.
+    // textures of every size used are kept, so going back to a size does not reallocate.
+    // the framebuffer is blitted to the surface with the configured filter.
+    class resolution_controller
+    {
+    public:
+        resolution_controller(scene& s, uint32_t framebuffer_idx, resolution_settings settings = {});
+        ~resolution_controller() = default;
+
+        // around the gpu work of the frame.
+        void begin_frame();
+        void end_frame();
+
+        // picks the scale for the next frame and resizes the framebuffer to it relatively to the surface.
+        // returns true if textures of the framebuffer changed, compiled commands have to be invalidated then.
+        bool update(uint32_t surface_width, uint32_t surface_height);
+
+        float get_scale() const;
+        float get_frame_ms() const;
+        std::pair<uint32_t, uint32_t> get_render_size() const;
+
+    private:
+        using size = std::pair<uint32_t, uint32_t>;
+
+        float get_step_scale(uint32_t step) const;
+        void apply_size(size render_size);
+
+        scene& m_scene;
+        uint32_t m_framebuffer_idx;
+        resolution_settings m_settings;
+
+        gl::gpu_timer m_timer;
+        std::chrono::steady_clock::time_point m_frame_start;
+        double m_cpu_frame_ms{0};
+        float m_frame_ms{0};
+        bool m_has_frame_ms{false};
+        bool m_has_gpu_time{false};
+
+        uint32_t m_step;
+        uint32_t m_frames_over{0};
+        uint32_t m_frames_under{0};
+
+        size m_surface_size{0, 0};
+        size m_render_size{0, 0};
+        // textures of the attachments of the framebuffer for every size which was used, in attachment order.
+        std::map<size, std::vector<gl::scene::texture>> m_textures;
+    };
+} // namespace gl::scene
@@ -4,12 +4,17 @@
 
 #include <gl/scene/meshes.hpp>
 #include <gl/framebuffer_object.hpp>
+#include <gl/program_cache.hpp>
 #include <gl/scene/attachment.hpp>
 #include <gl/scene/framebuffer.hpp>
 #include <gl/scene/pass.hpp>
+#include <gl/scene/vertex_pool.hpp>
 #include <gl/scene/parameter.hpp>
+#include <gl/state_cache.hpp>
+#include <gl/uniform_stream.hpp>
 
 #include <vector>
+#include <string>
 
 namespace gl::scene
 {
@@ -32,6 +37,8 @@ namespace gl::scene
         uint32_t material_idx = -1;
 
         drawable::topology topo = drawable::topology::triangles;
+        // drawn after opaque drawables of the pass, e.g. environment skybox.
+        bool background = false;
     };
 
 
@@ -44,8 +51,24 @@ namespace gl::scene
 
         render_command::type type;
 
-        uint32_t source_index;
-        uint32_t dst_index;
+        uint32_t source_index{0};
+        // second pass of a blit, unused by other commands.
+        uint32_t dst_index{0};
+    };
+
+
+    struct animation
+    {
+        struct clip
+        {
+            std::string name;
+            uint32_t first_key = 0;
+            uint32_t keys_count = 0;
+        };
+
+        uint32_t texture_idx = -1;
+        uint32_t joints_count = 0;
+        std::vector<animation::clip> clips;
     };
 
     struct scene
@@ -57,15 +80,32 @@ namespace gl::scene
         std::vector<gl::scene::framebuffer> framebuffers;
         std::vector<gl::scene::pass> passes;
         std::vector<gl::scene::texture> textures;
-        std::vector<gl::scene::parameter> parameters;
+        gl::scene::parameter_arena parameters;
         std::vector<gl::scene::render_command> commands;
+        std::vector<gl::scene::animation> animations;
 
         std::vector<gl::framebuffer_object> fbos;
-        std::vector<gl::program> shaders;
+        // programs are linked on the first draw of their materials, see program_cache.
+        mutable std::vector<gl::program> shaders;
+        // materials with the same sources share a program of shaders.
+        mutable gl::program_cache programs;
         std::vector<gl::vertex_array_object> vertex_sources;
+
+        // shared storage of the meshes vertices and indices.
+        gl::buffer_arena<GL_ARRAY_BUFFER> vertex_arena;
+        gl::buffer_arena<GL_ELEMENT_ARRAY_BUFFER> index_arena;
+        std::vector<gl::scene::vertex_pool> vertex_pools;
+
+        // invalidated and counted per draw call of the scene.
+        mutable gl::state_cache state;
+        // uniform blocks of the drawables, repacked and uploaded per draw call of the scene.
+        mutable gl::uniform_stream uniforms;
     };
 
+    // compile and replay a command_list once, keep a command_list to draw the same commands every frame.
     void draw(const scene& s, const std::vector<uint32_t>&, uint32_t pass_idx);
 
+    void draw(const scene& s, const std::vector<render_command>& commands, uint32_t surface_width, uint32_t surface_height);
+
     void draw(const scene& s, uint32_t surface_width, uint32_t surface_height);
 } // namespace gl::scene
@@ -0,0 +1,234 @@
+
+
+#include "vertex_pool.hpp"
+
+#include <gl/scene/scene.hpp>
+
+#include <algorithm>
+#include <cassert>
+
+
+namespace
+{
+    uint32_t get_type_size(uint32_t type)
+    {
+        switch (type) {
+            case GL_BYTE:
+            case GL_UNSIGNED_BYTE:
+                return 1;
+            case GL_SHORT:
+            case GL_UNSIGNED_SHORT:
+                return 2;
+            case GL_INT:
+            case GL_UNSIGNED_INT:
+            case GL_FLOAT:
+                return 4;
+            default:
+                throw std::runtime_error("unsupported vertex attribute type.");
+        }
+    }
+} // namespace
+
+
+uint32_t gl::scene::vertex_attribute::get_size() const
+{
+    return components * get_type_size(type);
+}
+
+
+bool gl::scene::vertex_attribute::operator==(const gl::scene::vertex_attribute& r) const
+{
+    return location == r.location && components == r.components && type == r.type && normalized == r.normalized;
+}
+
+
+gl::scene::vertex_pool::vertex_pool(
+    gl::scene::scene& s,
+    std::vector<gl::scene::vertex_attribute> format,
+    uint32_t indices_type,
+    uint32_t vertices_capacity,
+    uint32_t indices_capacity,
+    uint32_t slots_capacity)
+    : m_format(std::move(format))
+    , m_indices_type(indices_type)
+    , m_index_size(get_type_size(indices_type))
+    , m_vertex_source(s.vertex_sources.size())
+    , m_vertices_capacity(vertices_capacity)
+    , m_indices_capacity(indices_capacity)
+    , m_slots_capacity(slots_capacity)
+{
+    auto& vao = s.vertex_sources.emplace_back();
+
+    for (const auto& attribute : m_format) {
+        const auto& stream = m_streams.emplace_back(s.vertex_arena.allocate(attribute.get_size() * m_vertices_capacity, 16));
+        vao.add_vertex_array(
+            s.vertex_arena.get_buffer(stream),
+            attribute.components,
+            attribute.get_size(),
+            stream.offset,
+            attribute.type,
+            attribute.normalized,
+            attribute.location);
+    }
+
+    m_slots_stream = s.vertex_arena.allocate(sizeof(float) * m_vertices_capacity, 16);
+    vao.add_vertex_array(s.vertex_arena.get_buffer(m_slots_stream), 1, sizeof(float), m_slots_stream.offset, GL_FLOAT, GL_FALSE, draw_slot_location);
+
+    m_indices = s.index_arena.allocate(m_index_size * m_indices_capacity, 4);
+
+    vao.bind();
+    s.index_arena.get_buffer(m_indices).bind();
+    vao.unbind();
+    s.index_arena.get_buffer(m_indices).unbind();
+
+    m_draw_data.resize(m_slots_capacity * draw_data_texels * 4, 0.f);
+    m_draw_data_buffer.fill(m_draw_data.data(), m_draw_data.size() * sizeof(float), gl::buffer<GL_TEXTURE_BUFFER>::usage_type::dynamic_usage);
+
+    glGenTextures(1, &m_draw_data_texture);
+    glBindTexture(GL_TEXTURE_BUFFER, m_draw_data_texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, m_draw_data_buffer);
+    glBindTexture(GL_TEXTURE_BUFFER, 0);
+}
+
+
+gl::scene::vertex_pool::vertex_pool(gl::scene::vertex_pool&& src) noexcept
+{
+    *this = std::move(src);
+}
+
+
+gl::scene::vertex_pool& gl::scene::vertex_pool::operator=(gl::scene::vertex_pool&& src) noexcept
+{
+    if (this != &src) {
+        m_format = std::move(src.m_format);
+        m_indices_type = src.m_indices_type;
+        m_index_size = src.m_index_size;
+        m_vertex_source = src.m_vertex_source;
+        m_streams = std::move(src.m_streams);
+        m_slots_stream = src.m_slots_stream;
+        m_indices = src.m_indices;
+        m_vertices_capacity = src.m_vertices_capacity;
+        m_indices_capacity = src.m_indices_capacity;
+        m_slots_capacity = src.m_slots_capacity;
+        m_vertices_count = src.m_vertices_count;
+        m_indices_count = src.m_indices_count;
+        m_slots_count = src.m_slots_count;
+        m_draw_data_buffer = std::move(src.m_draw_data_buffer);
+        std::swap(m_draw_data_texture, src.m_draw_data_texture);
+        m_draw_data = std::move(src.m_draw_data);
+        m_dirty_first = src.m_dirty_first;
+        m_dirty_last = src.m_dirty_last;
+    }
+
+    return *this;
+}
+
+
+gl::scene::vertex_pool::~vertex_pool()
+{
+    if (m_draw_data_texture != 0) {
+        glDeleteTextures(1, &m_draw_data_texture);
+    }
+}
+
+
+bool gl::scene::vertex_pool::is_compatible(const std::vector<gl::scene::vertex_attribute>& format, uint32_t indices_type) const
+{
+    return m_format == format && m_indices_type == indices_type;
+}
+
+
+bool gl::scene::vertex_pool::can_fit(uint32_t vertices_count, uint32_t indices_count) const
+{
+    return m_vertices_count + vertices_count <= m_vertices_capacity
+        && m_indices_count + indices_count <= m_indices_capacity
+        && m_slots_count < m_slots_capacity;
+}
+
+
+gl::scene::vertex_pool::allocation gl::scene::vertex_pool::append(
+    gl::scene::scene& s,
+    const std::vector<const void*>& attributes,
+    uint32_t vertices_count,
+    const void* indices,
+    uint32_t indices_count)
+{
+    assert(attributes.size() == m_format.size());
+    assert(can_fit(vertices_count, indices_count));
+
+    for (size_t i = 0; i < m_format.size(); ++i) {
+        const auto attribute_size = m_format[i].get_size();
+        s.vertex_arena.upload(m_streams[i], attributes[i], attribute_size * vertices_count, attribute_size * m_vertices_count);
+    }
+
+    allocation res{int32_t(m_vertices_count), m_indices.offset + m_index_size * m_indices_count, m_slots_count};
+
+    const std::vector<float> slots(vertices_count, float(res.slot));
+    s.vertex_arena.upload(m_slots_stream, slots.data(), sizeof(float) * vertices_count, sizeof(float) * m_vertices_count);
+
+    s.index_arena.upload(m_indices, indices, m_index_size * indices_count, m_index_size * m_indices_count);
+
+    m_vertices_count += vertices_count;
+    m_indices_count += indices_count;
+    ++m_slots_count;
+
+    return res;
+}
+
+
+uint32_t gl::scene::vertex_pool::get_vertex_source() const
+{
+    return m_vertex_source;
+}
+
+
+uint32_t gl::scene::vertex_pool::get_indices_type() const
+{
+    return m_indices_type;
+}
+
+
+float* gl::scene::vertex_pool::get_draw_data(uint32_t slot) const
+{
+    assert(slot < m_slots_count);
+
+    if (m_dirty_first == m_dirty_last) {
+        m_dirty_first = slot;
+        m_dirty_last = slot + 1;
+    } else {
+        m_dirty_first = std::min(m_dirty_first, slot);
+        m_dirty_last = std::max(m_dirty_last, slot + 1);
+    }
+
+    return m_draw_data.data() + slot * draw_data_texels * 4;
+}
+
+
+void gl::scene::vertex_pool::upload_draw_data() const
+{
+    if (m_dirty_first == m_dirty_last) {
+        return;
+    }
+
+    // orphaned, draws of the previous frame may still read the old storage.
+    m_draw_data_buffer.fill(m_draw_data.data(), m_slots_count * draw_data_texels * 4 * sizeof(float), gl::buffer<GL_TEXTURE_BUFFER>::usage_type::dynamic_usage);
+    m_dirty_first = m_dirty_last = 0;
+}
+
+
+void gl::scene::vertex_pool::upload_draw_data(uint32_t slot) const
+{
+    assert(slot < m_slots_count);
+    assert(m_dirty_first <= slot && slot < m_dirty_last);
+
+    // draws of this frame were recorded against the current storage, so the written slots are updated in place.
+    constexpr auto slot_size = draw_data_texels * 4 * sizeof(float);
+    m_draw_data_buffer.update(m_draw_data.data() + m_dirty_first * draw_data_texels * 4, (m_dirty_last - m_dirty_first) * slot_size, m_dirty_first * slot_size);
+    m_dirty_first = m_dirty_last = 0;
+}
+
+
+uint32_t gl::scene::vertex_pool::get_draw_data_texture() const
+{
+    return m_draw_data_texture;
+}
@@ -0,0 +1,97 @@
+
+
+
+#pragma once
+
+#include <gl/buffer_arena.hpp>
+
+#include <cinttypes>
+#include <vector>
+
+namespace gl::scene
+{
+    struct scene;
+
+    struct vertex_attribute
+    {
+        int32_t location;
+        uint32_t components;
+        uint32_t type;
+        bool normalized;
+
+        uint32_t get_size() const;
+        bool operator==(const vertex_attribute&) const;
+    };
+
+    // meshes of one vertex format and index type sharing a vao, addressed by base vertex and index offset,
+    // so a run of them can be drawn with one glMultiDrawElementsBaseVertex.
+    // glsl 410 has no gl_DrawID, so every vertex carries the slot of its mesh (attribute draw_slot_location)
+    // and per draw data is fetched by slot from a texture buffer (draw_data_texels rgba32f texels per slot).
+    // a mesh may appear only once in a multi draw.
+    class vertex_pool
+    {
+    public:
+        static constexpr int32_t draw_slot_location = 8;
+        static constexpr uint32_t draw_data_texels = 9;
+
+        struct allocation
+        {
+            int32_t base_vertex;
+            uint32_t indices_offset;
+            uint32_t slot;
+        };
+
+        vertex_pool(
+            scene& s,
+            std::vector<vertex_attribute> format,
+            uint32_t indices_type,
+            uint32_t vertices_capacity,
+            uint32_t indices_capacity,
+            uint32_t slots_capacity);
+
+        vertex_pool(const vertex_pool&) = delete;
+        vertex_pool& operator=(const vertex_pool&) = delete;
+        vertex_pool(vertex_pool&&) noexcept;
+        vertex_pool& operator=(vertex_pool&&) noexcept;
+        ~vertex_pool();
+
+        bool is_compatible(const std::vector<vertex_attribute>& format, uint32_t indices_type) const;
+        bool can_fit(uint32_t vertices_count, uint32_t indices_count) const;
+        // attributes data in the format order.
+        allocation append(scene& s, const std::vector<const void*>& attributes, uint32_t vertices_count, const void* indices, uint32_t indices_count);
+
+        uint32_t get_vertex_source() const;
+        uint32_t get_indices_type() const;
+
+        // per draw data of the slots, uploaded once per frame when written.
+        float* get_draw_data(uint32_t slot) const;
+        void upload_draw_data() const;
+        // rewrites the written slots in place, for a mesh drawn again in the same frame with other draw data.
+        void upload_draw_data(uint32_t slot) const;
+        uint32_t get_draw_data_texture() const;
+
+    private:
+        std::vector<vertex_attribute> m_format;
+        uint32_t m_indices_type;
+        uint32_t m_index_size;
+
+        uint32_t m_vertex_source;
+        std::vector<gl::buffer_arena<GL_ARRAY_BUFFER>::region> m_streams;
+        gl::buffer_arena<GL_ARRAY_BUFFER>::region m_slots_stream;
+        gl::buffer_arena<GL_ELEMENT_ARRAY_BUFFER>::region m_indices;
+
+        uint32_t m_vertices_capacity;
+        uint32_t m_indices_capacity;
+        uint32_t m_slots_capacity;
+        uint32_t m_vertices_count{0};
+        uint32_t m_indices_count{0};
+        uint32_t m_slots_count{0};
+
+        mutable gl::buffer<GL_TEXTURE_BUFFER> m_draw_data_buffer;
+        uint32_t m_draw_data_texture{0};
+        mutable std::vector<float> m_draw_data;
+        // slots written since the last upload, empty when first equals last.
+        mutable uint32_t m_dirty_first{0};
+        mutable uint32_t m_dirty_last{0};
+    };
+} // namespace gl::scene
@@ -2,23 +2,100 @@
 
 #include "shaders.hpp"
 
+#include <gl/extensions.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <vector>
+
 namespace
 {
-    void link_program(GLuint program)
+    void check_link_status(GLuint program)
     {
-        glLinkProgram(program);
         int32_t success;
         glGetProgramiv(program, GL_LINK_STATUS, &success);
 
         if (success == GL_FALSE) {
-            int32_t log_len;
+            int32_t log_len = 0;
             glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_len);
+            // a rejected binary may have no log.
+            log_len = std::max(log_len, 1);
             auto log = std::make_unique<char[]>(log_len);
+            log[0] = '\0';
             glGetProgramInfoLog(program, log_len, nullptr, log.get());
             glDeleteProgram(program);
             throw std::runtime_error(log.get());
         }
     }
+
+
+    void link_program(GLuint program)
+    {
+        // binaries are cached by gl::program_cache.
+        glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+        glLinkProgram(program);
+        check_link_status(program);
+    }
+
+
+    template<typename GetIv, typename GetLog>
+    std::string get_info_log(uint32_t object, GetIv get_iv, GetLog get_log)
+    {
+        int32_t log_len = 0;
+        get_iv(object, GL_INFO_LOG_LENGTH, &log_len);
+
+        std::string log(std::max(log_len, 1), '\0');
+        get_log(object, log.size(), nullptr, log.data());
+        log.resize(std::max(log_len - 1, 0));
+
+        return log;
+    }
+
+
+    bool is_sampler(uint32_t type)
+    {
+        switch (type) {
+            case GL_SAMPLER_1D:
+            case GL_SAMPLER_2D:
+            case GL_SAMPLER_3D:
+            case GL_SAMPLER_CUBE:
+            case GL_SAMPLER_1D_SHADOW:
+            case GL_SAMPLER_2D_SHADOW:
+            case GL_SAMPLER_1D_ARRAY:
+            case GL_SAMPLER_2D_ARRAY:
+            case GL_SAMPLER_1D_ARRAY_SHADOW:
+            case GL_SAMPLER_2D_ARRAY_SHADOW:
+            case GL_SAMPLER_2D_MULTISAMPLE:
+            case GL_SAMPLER_2D_MULTISAMPLE_ARRAY:
+            case GL_SAMPLER_CUBE_SHADOW:
+            case GL_SAMPLER_BUFFER:
+            case GL_SAMPLER_2D_RECT:
+            case GL_SAMPLER_2D_RECT_SHADOW:
+            case GL_INT_SAMPLER_1D:
+            case GL_INT_SAMPLER_2D:
+            case GL_INT_SAMPLER_3D:
+            case GL_INT_SAMPLER_CUBE:
+            case GL_INT_SAMPLER_1D_ARRAY:
+            case GL_INT_SAMPLER_2D_ARRAY:
+            case GL_INT_SAMPLER_2D_MULTISAMPLE:
+            case GL_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+            case GL_INT_SAMPLER_BUFFER:
+            case GL_INT_SAMPLER_2D_RECT:
+            case GL_UNSIGNED_INT_SAMPLER_1D:
+            case GL_UNSIGNED_INT_SAMPLER_2D:
+            case GL_UNSIGNED_INT_SAMPLER_3D:
+            case GL_UNSIGNED_INT_SAMPLER_CUBE:
+            case GL_UNSIGNED_INT_SAMPLER_1D_ARRAY:
+            case GL_UNSIGNED_INT_SAMPLER_2D_ARRAY:
+            case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE:
+            case GL_UNSIGNED_INT_SAMPLER_2D_MULTISAMPLE_ARRAY:
+            case GL_UNSIGNED_INT_SAMPLER_BUFFER:
+            case GL_UNSIGNED_INT_SAMPLER_2D_RECT:
+                return true;
+            default:
+                return false;
+        }
+    }
 }
 
 gl::program::program(
@@ -31,6 +108,7 @@ gl::program::program(
     glAttachShader(m_gl_handler, vs.m_gl_handler);
     glAttachShader(m_gl_handler, fs.m_gl_handler);
     link_program(m_gl_handler);
+    reflect();
 }
 
 
@@ -40,11 +118,50 @@ gl::program::program(const gl::shader<GL_VERTEX_SHADER>& vs, const gl::shader<GL
     glAttachShader(m_gl_handler, vs.m_gl_handler);
     glAttachShader(m_gl_handler, fs.m_gl_handler);
     link_program(m_gl_handler);
+    reflect();
+}
+
+
+gl::program::program(const gl::program_sources& sources)
+    : m_gl_handler{glCreateProgram()}
+{
+    auto compile = [this](uint32_t type, const std::string& source) {
+        const auto shader = glCreateShader(type);
+        const auto source_ptr = source.c_str();
+        glShaderSource(shader, 1, &source_ptr, nullptr);
+        glCompileShader(shader);
+        glAttachShader(m_gl_handler, shader);
+        m_shaders.emplace_back(shader);
+    };
+
+    compile(GL_VERTEX_SHADER, sources.vs);
+    compile(GL_FRAGMENT_SHADER, sources.fs);
+
+    if (!sources.gs.empty()) {
+        compile(GL_GEOMETRY_SHADER, sources.gs);
+    }
+
+    // statuses are not queried here, that would wait for the driver.
+    glProgramParameteri(m_gl_handler, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    glLinkProgram(m_gl_handler);
+}
+
+
+gl::program::program(uint32_t binary_format, const std::vector<uint8_t>& binary)
+    : m_gl_handler{glCreateProgram()}
+{
+    glProgramBinary(m_gl_handler, binary_format, binary.data(), binary.size());
+    check_link_status(m_gl_handler);
+    reflect();
 }
 
 
 gl::program::~program()
 {
+    for (const auto shader : m_shaders) {
+        glDeleteShader(shader);
+    }
+
     glDeleteProgram(m_gl_handler);
 }
 
@@ -59,12 +176,72 @@ gl::program& gl::program::operator=(gl::program&& src) noexcept
 {
     if (this != &src) {
         std::swap(m_gl_handler, src.m_gl_handler);
+        std::swap(m_uniforms, src.m_uniforms);
+        std::swap(m_uniform_blocks, src.m_uniform_blocks);
+        std::swap(m_shaders, src.m_shaders);
+        std::swap(m_uniform_versions, src.m_uniform_versions);
     }
 
     return *this;
 }
 
 
+bool gl::program::is_ready() const
+{
+    if (m_shaders.empty() || !has_extension("GL_KHR_parallel_shader_compile")) {
+        return true;
+    }
+
+    int32_t completed = GL_FALSE;
+    glGetProgramiv(m_gl_handler, GL_COMPLETION_STATUS_KHR, &completed);
+
+    return completed == GL_TRUE;
+}
+
+
+void gl::program::finish()
+{
+    if (m_shaders.empty()) {
+        return;
+    }
+
+    int32_t success;
+    glGetProgramiv(m_gl_handler, GL_LINK_STATUS, &success);
+
+    std::string log;
+
+    if (success == GL_FALSE) {
+        // the log of the first shader which failed to compile, the link log otherwise.
+        for (const auto shader : m_shaders) {
+            int32_t compiled;
+            glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+
+            if (compiled == GL_FALSE) {
+                log = get_info_log(shader, glGetShaderiv, glGetShaderInfoLog);
+                break;
+            }
+        }
+
+        if (log.empty()) {
+            log = get_info_log(m_gl_handler, glGetProgramiv, glGetProgramInfoLog);
+        }
+    }
+
+    for (const auto shader : m_shaders) {
+        glDetachShader(m_gl_handler, shader);
+        glDeleteShader(shader);
+    }
+
+    m_shaders.clear();
+
+    if (success == GL_FALSE) {
+        throw std::runtime_error(log);
+    }
+
+    reflect();
+}
+
+
 void gl::program::bind() const
 {
     glUseProgram(m_gl_handler);
@@ -75,3 +252,164 @@ void gl::program::unbind() const
 {
     glUseProgram(0);
 }
+
+
+const std::unordered_map<std::string, gl::program::uniform>& gl::program::get_uniforms() const
+{
+    return m_uniforms;
+}
+
+
+const gl::program::uniform* gl::program::get_uniform(const std::string& uniform_name) const
+{
+    const auto it = m_uniforms.find(uniform_name);
+    return it != m_uniforms.end() ? &it->second : nullptr;
+}
+
+
+int32_t gl::program::get_uniform_location(const std::string& uniform_name) const
+{
+    const auto uniform = get_uniform(uniform_name);
+    return uniform != nullptr ? uniform->location : -1;
+}
+
+
+int32_t gl::program::get_texture_unit(const std::string& sampler_name) const
+{
+    const auto uniform = get_uniform(sampler_name);
+    return uniform != nullptr ? uniform->texture_unit : -1;
+}
+
+
+const std::vector<gl::program::uniform_block>& gl::program::get_uniform_blocks() const
+{
+    return m_uniform_blocks;
+}
+
+
+const gl::program::uniform_block* gl::program::get_uniform_block(int32_t binding) const
+{
+    for (const auto& block : m_uniform_blocks) {
+        if (block.binding == binding) {
+            return &block;
+        }
+    }
+
+    return nullptr;
+}
+
+
+std::vector<uint8_t> gl::program::get_binary(uint32_t& binary_format) const
+{
+    int32_t length = 0;
+    glGetProgramiv(m_gl_handler, GL_PROGRAM_BINARY_LENGTH, &length);
+
+    std::vector<uint8_t> binary(length);
+
+    if (length > 0) {
+        glGetProgramBinary(m_gl_handler, length, nullptr, &binary_format, binary.data());
+    }
+
+    return binary;
+}
+
+
+bool gl::program::update_uniform_version(int32_t location, uint32_t parameter, uint32_t version) const
+{
+    assert(location >= 0);
+
+    if (size_t(location) >= m_uniform_versions.size()) {
+        m_uniform_versions.resize(location + 1);
+    }
+
+    auto& last = m_uniform_versions[location];
+
+    if (last.parameter == parameter && last.version == version) {
+        return false;
+    }
+
+    last = {parameter, version};
+    return true;
+}
+
+
+void gl::program::reflect()
+{
+    int32_t blocks_count = 0;
+    int32_t max_block_name_length = 0;
+    glGetProgramiv(m_gl_handler, GL_ACTIVE_UNIFORM_BLOCKS, &blocks_count);
+    glGetProgramiv(m_gl_handler, GL_ACTIVE_UNIFORM_BLOCK_MAX_NAME_LENGTH, &max_block_name_length);
+
+    std::string block_name(std::max(max_block_name_length, 1), '\0');
+    int32_t next_block_binding = draw_block_binding + 1;
+
+    for (int32_t i = 0; i < blocks_count; ++i) {
+        int32_t name_length = 0;
+        glGetActiveUniformBlockName(m_gl_handler, i, block_name.size(), &name_length, block_name.data());
+
+        auto& block = m_uniform_blocks.emplace_back();
+        block.name.assign(block_name.data(), name_length);
+        glGetActiveUniformBlockiv(m_gl_handler, i, GL_UNIFORM_BLOCK_DATA_SIZE, &block.size);
+
+        if (block.name == frame_block_name) {
+            block.binding = frame_block_binding;
+        } else if (block.name == draw_block_name) {
+            block.binding = draw_block_binding;
+        } else {
+            block.binding = next_block_binding++;
+        }
+
+        glUniformBlockBinding(m_gl_handler, i, block.binding);
+    }
+
+    int32_t uniforms_count = 0;
+    int32_t max_name_length = 0;
+    glGetProgramiv(m_gl_handler, GL_ACTIVE_UNIFORMS, &uniforms_count);
+    glGetProgramiv(m_gl_handler, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_length);
+
+    std::string name(std::max(max_name_length, 1), '\0');
+    int32_t next_texture_unit = 0;
+
+    for (int32_t i = 0; i < uniforms_count; ++i) {
+        int32_t name_length = 0;
+        uniform curr_uniform{};
+
+        glGetActiveUniform(m_gl_handler, i, name.size(), &name_length, &curr_uniform.size, &curr_uniform.type, name.data());
+
+        const std::string uniform_name(name.data(), name_length);
+        curr_uniform.location = glGetUniformLocation(m_gl_handler, uniform_name.c_str());
+
+        // uniforms of blocks have no location.
+        if (curr_uniform.location < 0) {
+            const auto index = uint32_t(i);
+            int32_t block_index = -1;
+            glGetActiveUniformsiv(m_gl_handler, 1, &index, GL_UNIFORM_BLOCK_INDEX, &block_index);
+
+            if (block_index < 0) {
+                continue;
+            }
+
+            curr_uniform.block_binding = m_uniform_blocks.at(block_index).binding;
+            glGetActiveUniformsiv(m_gl_handler, 1, &index, GL_UNIFORM_OFFSET, &curr_uniform.block_offset);
+        }
+
+        if (is_sampler(curr_uniform.type)) {
+            curr_uniform.texture_unit = next_texture_unit;
+            next_texture_unit += curr_uniform.size;
+
+            std::vector<int32_t> units(curr_uniform.size);
+
+            for (int32_t unit = 0; unit < curr_uniform.size; ++unit) {
+                units[unit] = curr_uniform.texture_unit + unit;
+            }
+
+            glProgramUniform1iv(m_gl_handler, curr_uniform.location, curr_uniform.size, units.data());
+        }
+
+        m_uniforms.emplace(uniform_name, curr_uniform);
+
+        if (const auto pos = uniform_name.rfind("[0]"); pos != std::string::npos && pos + 3 == uniform_name.size()) {
+            m_uniforms.emplace(uniform_name.substr(0, pos), curr_uniform);
+        }
+    }
+}
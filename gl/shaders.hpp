@@ -6,8 +6,11 @@
 #include <glm/mat4x4.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+#include <limits>
 #include <string>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 namespace gl
 {
@@ -142,11 +145,51 @@ namespace gl
         uint32_t m_gl_handler{0};
     };
 
+    struct program_sources
+    {
+        std::string vs;
+        std::string fs;
+        // empty if the program has no geometry stage.
+        std::string gs{};
+    };
+
     class program
     {
     public:
+        struct uniform
+        {
+            int32_t location = -1;
+            uint32_t type = 0;
+            int32_t size = 0;
+            // fixed texture unit of a sampler, -1 for other uniforms.
+            int32_t texture_unit = -1;
+            // binding point and std140 offset of a uniform block member, -1 for default block uniforms.
+            int32_t block_binding = -1;
+            int32_t block_offset = -1;
+        };
+
+        struct uniform_block
+        {
+            std::string name;
+            int32_t binding = -1;
+            int32_t size = 0;
+        };
+
+        // blocks shared by programs get fixed binding points, others are numbered after them.
+        static constexpr const char* frame_block_name = "frame_data";
+        static constexpr const char* draw_block_name = "draw_data";
+        static constexpr int32_t frame_block_binding = 0;
+        static constexpr int32_t draw_block_binding = 1;
+
+        // no gl program, e.g. the place of a program which is linked later.
+        program() = default;
         program(const shader<GL_VERTEX_SHADER>& vs, const shader<GL_FRAGMENT_SHADER>& fs);
         program(const shader<GL_VERTEX_SHADER>& vs, const shader<GL_FRAGMENT_SHADER>& fs, const shader<GL_GEOMETRY_SHADER>& gs);
+        // compiles and links without waiting for the driver. the program is not usable before finish,
+        // which blocks until the driver is done unless is_ready returns true.
+        explicit program(const program_sources& sources);
+        // binary of get_binary, throws if the driver does not accept it anymore.
+        program(uint32_t binary_format, const std::vector<uint8_t>& binary);
         ~program();
 
         program(const program&) = delete;
@@ -156,20 +199,63 @@ namespace gl
 
         program& operator=(program&& src) noexcept;
 
+        // true if finish would not block, always true without KHR_parallel_shader_compile.
+        bool is_ready() const;
+        // throws the compile or link log if the build failed.
+        void finish();
+
         void bind() const;
         void unbind() const;
 
+        operator uint32_t() const
+        {
+            return m_gl_handler;
+        }
+
+        // active uniforms reflected at link time, arrays are available by the name with and without [0].
+        const std::unordered_map<std::string, uniform>& get_uniforms() const;
+        const uniform* get_uniform(const std::string& uniform_name) const;
+        int32_t get_uniform_location(const std::string& uniform_name) const;
+        int32_t get_texture_unit(const std::string& sampler_name) const;
+        const std::vector<uniform_block>& get_uniform_blocks() const;
+        const uniform_block* get_uniform_block(int32_t binding) const;
+        std::vector<uint8_t> get_binary(uint32_t& binary_format) const;
+
+        // remembers the scene parameter and its version last uploaded to the location,
+        // returns false if the location already has them and the upload can be skipped.
+        bool update_uniform_version(int32_t location, uint32_t parameter, uint32_t version) const;
+
         template<typename UniformType, typename... Args>
         void set_uniform(const std::string& uniform_name, const UniformType& uniform_data, Args&&... args) const
         {
-            auto loc = glGetUniformLocation(m_gl_handler, uniform_name.c_str());
+            set_uniform(get_uniform_location(uniform_name), uniform_data, std::forward<Args>(args)...);
+        }
 
-            if (loc >= 0) {
-                uniform_resolver<UniformType>{}(loc, uniform_data, std::forward<Args>(args)...);
+        // program must be bound.
+        template<typename UniformType, typename... Args>
+        void set_uniform(int32_t location, const UniformType& uniform_data, Args&&... args) const
+        {
+            if (location >= 0) {
+                uniform_resolver<UniformType>{}(location, uniform_data, std::forward<Args>(args)...);
             }
         }
 
     private:
+        void reflect();
+
         uint32_t m_gl_handler{0};
+        // shaders of a build which is not finished yet.
+        std::vector<uint32_t> m_shaders;
+
+        struct uniform_version
+        {
+            uint32_t parameter = std::numeric_limits<uint32_t>::max();
+            uint32_t version = 0;
+        };
+
+        // by location.
+        mutable std::vector<uniform_version> m_uniform_versions;
+        std::unordered_map<std::string, uniform> m_uniforms;
+        std::vector<uniform_block> m_uniform_blocks;
     };
 } // namespace gl
@@ -0,0 +1,164 @@
+
+
+#include "state_cache.hpp"
+
+
+gl::state_cache::state_cache()
+{
+    invalidate();
+}
+
+
+void gl::state_cache::invalidate()
+{
+    m_program = unknown;
+    m_vertex_array = unknown;
+    m_active_unit = unknown;
+    m_texture_units.fill(texture_unit{});
+    m_uniform_buffers.fill(buffer_range{});
+
+    m_depth_test = unknown;
+    m_depth_func = unknown;
+    m_depth_write = unknown;
+    m_cull_face = unknown;
+    m_cull_mode = unknown;
+    m_color_mask = unknown;
+}
+
+
+void gl::state_cache::reset_counters()
+{
+    m_counters = counters{};
+}
+
+
+const gl::state_cache::counters& gl::state_cache::get_counters() const
+{
+    return m_counters;
+}
+
+
+void gl::state_cache::use_program(uint32_t program)
+{
+    if (update(m_program, program)) {
+        glUseProgram(program);
+    }
+}
+
+
+void gl::state_cache::bind_vertex_array(uint32_t vertex_array)
+{
+    if (update(m_vertex_array, vertex_array)) {
+        glBindVertexArray(vertex_array);
+    }
+}
+
+
+void gl::state_cache::bind_texture(uint32_t unit, uint32_t target, uint32_t texture)
+{
+    assert(unit < max_texture_units);
+    auto& curr_unit = m_texture_units[unit];
+
+    if (curr_unit.target == target && curr_unit.texture == texture) {
+        ++m_counters.elided;
+        return;
+    }
+
+    if (update(m_active_unit, unit)) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+    }
+
+    // a unit has a binding per target, only the last one is tracked, so previous target is left bound.
+    curr_unit.target = target;
+    curr_unit.texture = texture;
+    glBindTexture(target, texture);
+    ++m_counters.issued;
+}
+
+
+void gl::state_cache::bind_uniform_buffer(uint32_t binding, uint32_t buffer, uint32_t offset, uint32_t size)
+{
+    assert(binding < max_uniform_buffers);
+    auto& curr_range = m_uniform_buffers[binding];
+
+    if (curr_range.buffer == buffer && curr_range.offset == offset && curr_range.size == size) {
+        ++m_counters.elided;
+        return;
+    }
+
+    curr_range = buffer_range{buffer, offset, size};
+    glBindBufferRange(GL_UNIFORM_BUFFER, binding, buffer, offset, size);
+    ++m_counters.issued;
+}
+
+
+void gl::state_cache::set_depth_test(bool enabled)
+{
+    set_capability(m_depth_test, GL_DEPTH_TEST, enabled);
+}
+
+
+void gl::state_cache::set_depth_func(uint32_t func)
+{
+    if (update(m_depth_func, func)) {
+        glDepthFunc(func);
+    }
+}
+
+
+void gl::state_cache::set_depth_write(bool enabled)
+{
+    if (update(m_depth_write, enabled)) {
+        glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    }
+}
+
+
+void gl::state_cache::set_cull_face(bool enabled)
+{
+    set_capability(m_cull_face, GL_CULL_FACE, enabled);
+}
+
+
+void gl::state_cache::set_cull_mode(uint32_t mode)
+{
+    if (update(m_cull_mode, mode)) {
+        glCullFace(mode);
+    }
+}
+
+
+void gl::state_cache::set_color_mask(bool r, bool g, bool b, bool a)
+{
+    const uint32_t mask = uint32_t(r) | uint32_t(g) << 1 | uint32_t(b) << 2 | uint32_t(a) << 3;
+
+    if (update(m_color_mask, mask)) {
+        glColorMask(r ? GL_TRUE : GL_FALSE, g ? GL_TRUE : GL_FALSE, b ? GL_TRUE : GL_FALSE, a ? GL_TRUE : GL_FALSE);
+    }
+}
+
+
+bool gl::state_cache::update(uint32_t& shadow, uint32_t value)
+{
+    if (shadow == value) {
+        ++m_counters.elided;
+        return false;
+    }
+
+    shadow = value;
+    ++m_counters.issued;
+
+    return true;
+}
+
+
+void gl::state_cache::set_capability(uint32_t& shadow, uint32_t capability, bool enabled)
+{
+    if (update(shadow, enabled)) {
+        if (enabled) {
+            glEnable(capability);
+        } else {
+            glDisable(capability);
+        }
+    }
+}
@@ -0,0 +1,89 @@
+
+
+
+#pragma once
+
+#include <gl/textures.hpp>
+
+#include <glad/glad.h>
+
+#include <array>
+#include <cinttypes>
+
+namespace gl
+{
+    // shadows the bound gl state and skips calls which would not change it.
+    // state changed behind the cache (bind_guard, direct gl calls) must be followed by invalidate().
+    class state_cache
+    {
+    public:
+        struct counters
+        {
+            uint32_t issued = 0;
+            uint32_t elided = 0;
+        };
+
+        state_cache();
+        ~state_cache() = default;
+
+        // forgets the shadowed state, every next call is issued.
+        void invalidate();
+        void reset_counters();
+        const counters& get_counters() const;
+
+        void use_program(uint32_t program);
+        void bind_vertex_array(uint32_t vertex_array);
+        void bind_texture(uint32_t unit, uint32_t target, uint32_t texture);
+
+        template<uint32_t TextureType>
+        void bind_texture(uint32_t unit, const texture<TextureType>& texture)
+        {
+            bind_texture(unit, TextureType, uint32_t(texture));
+        }
+
+        void bind_uniform_buffer(uint32_t binding, uint32_t buffer, uint32_t offset, uint32_t size);
+
+        void set_depth_test(bool enabled);
+        void set_depth_func(uint32_t func);
+        void set_depth_write(bool enabled);
+        void set_cull_face(bool enabled);
+        void set_cull_mode(uint32_t mode);
+        void set_color_mask(bool r, bool g, bool b, bool a);
+
+    private:
+        static constexpr uint32_t max_texture_units = 32;
+        static constexpr uint32_t max_uniform_buffers = 16;
+        static constexpr uint32_t unknown = uint32_t(-1);
+
+        struct texture_unit
+        {
+            uint32_t target = unknown;
+            uint32_t texture = unknown;
+        };
+
+        struct buffer_range
+        {
+            uint32_t buffer = unknown;
+            uint32_t offset = unknown;
+            uint32_t size = unknown;
+        };
+
+        bool update(uint32_t& shadow, uint32_t value);
+        void set_capability(uint32_t& shadow, uint32_t capability, bool enabled);
+
+        counters m_counters{};
+
+        uint32_t m_program{unknown};
+        uint32_t m_vertex_array{unknown};
+        uint32_t m_active_unit{unknown};
+        std::array<texture_unit, max_texture_units> m_texture_units{};
+        std::array<buffer_range, max_uniform_buffers> m_uniform_buffers{};
+
+        uint32_t m_depth_test{unknown};
+        uint32_t m_depth_func{unknown};
+        uint32_t m_depth_write{unknown};
+        uint32_t m_cull_face{unknown};
+        uint32_t m_cull_mode{unknown};
+        uint32_t m_color_mask{unknown};
+    };
+} // namespace gl
@@ -104,6 +104,20 @@ namespace gl
         }
     };
 
+    template<typename DataType, uint32_t UpdateTextureType>
+    struct texture_update_resolver
+    {
+    };
+
+    template<>
+    struct texture_update_resolver<const float, GL_TEXTURE_2D>
+    {
+        void operator()(const float* data, int32_t w, int32_t h, int32_t x = 0, int32_t y = 0) const
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, x, y, w, h, GL_RGBA, GL_FLOAT, data);
+        }
+    };
+
     template<uint32_t TextureType>
     class texture
     {
@@ -167,6 +181,13 @@ namespace gl
             texture_fill_resolver<DataType, TextureType>{}(data, w, h, std::forward<Args>(args)...);
         }
 
+        template<typename DataType, typename... Args>
+        void update(DataType* data, int32_t w, int32_t h, Args&&... args) const
+        {
+            bind_guard guard(*this);
+            texture_update_resolver<DataType, TextureType>{}(data, w, h, std::forward<Args>(args)...);
+        }
+
         operator uint32_t() const
         {
             return m_gl_handler;
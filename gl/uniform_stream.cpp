@@ -0,0 +1,76 @@
+
+
+#include "uniform_stream.hpp"
+
+#include <algorithm>
+
+
+gl::uniform_stream::~uniform_stream()
+{
+    if (m_gl_handler != 0) {
+        glDeleteBuffers(1, &m_gl_handler);
+    }
+}
+
+
+void gl::uniform_stream::begin()
+{
+    if (m_gl_handler == 0) {
+        glGenBuffers(1, &m_gl_handler);
+
+        int32_t alignment = 0;
+        glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+        m_alignment = std::max(alignment, 1);
+    }
+
+    m_data.clear();
+}
+
+
+uint32_t gl::uniform_stream::allocate(uint32_t size)
+{
+    assert(m_alignment > 0);
+
+    const uint32_t offset = (m_data.size() + m_alignment - 1) / m_alignment * m_alignment;
+    m_data.resize(offset + size, 0);
+
+    return offset;
+}
+
+
+uint8_t* gl::uniform_stream::get_data(uint32_t offset)
+{
+    return m_data.data() + offset;
+}
+
+
+void gl::uniform_stream::upload()
+{
+    if (m_data.empty()) {
+        return;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_gl_handler);
+
+    // storage of the same size is orphaned every frame so the driver can recycle it.
+    if (m_data.size() > m_capacity) {
+        m_capacity = m_data.size() * 3 / 2;
+    }
+
+    glBufferData(GL_UNIFORM_BUFFER, m_capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, m_data.size(), m_data.data());
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+
+uint32_t gl::uniform_stream::get_size() const
+{
+    return m_data.size();
+}
+
+
+uint32_t gl::uniform_stream::get_alignment() const
+{
+    assert(m_alignment > 0);
+    return m_alignment;
+}
@@ -0,0 +1,45 @@
+
+
+
+#pragma once
+
+#include <glad/glad.h>
+
+#include <cinttypes>
+#include <vector>
+
+namespace gl
+{
+    // per frame uniform blocks data. ranges are packed on the cpu, the whole frame is uploaded at once
+    // into orphaned buffer storage, so the driver never waits for draws of the previous frame.
+    class uniform_stream
+    {
+    public:
+        uniform_stream() = default;
+        ~uniform_stream();
+
+        uniform_stream(const uniform_stream&) = delete;
+        uniform_stream& operator=(const uniform_stream&) = delete;
+
+        void begin();
+        // returns offset of a new range aligned to GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT.
+        uint32_t allocate(uint32_t size);
+        uint8_t* get_data(uint32_t offset);
+        void upload();
+
+        uint32_t get_size() const;
+        // valid after the first begin.
+        uint32_t get_alignment() const;
+
+        operator uint32_t() const
+        {
+            return m_gl_handler;
+        }
+
+    private:
+        uint32_t m_gl_handler{0};
+        uint32_t m_alignment{0};
+        uint32_t m_capacity{0};
+        std::vector<uint8_t> m_data;
+    };
+} // namespace gl
@@ -36,6 +36,11 @@ namespace gl
         void bind() const;
         void unbind() const;
 
+        operator uint32_t() const
+        {
+            return m_gl_handler;
+        }
+
     private:
         uint32_t m_gl_handler{0};
         uint32_t m_next_location_idx{0};
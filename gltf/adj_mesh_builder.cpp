@@ -2,7 +2,9 @@
 
 #include "adj_mesh_builder.hpp"
 
+#include <gl/debug.hpp>
 #include <gltf/misc/gl_vao_utils.hpp>
+#include <gltf/misc/vertex_utils.hpp>
 
 #include <map>
 
@@ -132,6 +134,8 @@ void gltf::adj_mesh_builder::make_mesh(const gltf::mesh& mesh, gl::scene::scene&
 {
     for (const auto& subset : mesh.get_geom_subsets()) {
         make_subset(scene, subset);
+        scene.meshes.back().set_name(mesh.get_name());
+        scene.meshes.back().set_bounds(utils::get_bounds(subset));
         auto& s = const_cast<gltf::mesh::geom_subset&>(subset);
         assert(s.topo == gltf::mesh::topo::triangles);
         s.topo = gltf::mesh::topo::triangles_adj;
@@ -148,47 +152,47 @@ void gltf::adj_mesh_builder::make_subset(gl::scene::scene& gl_scene, gltf::mesh:
            geom_subset.indices.c_type == gltf::data_storage::component_type::u8);
 
     auto& vao = gl_scene.vertex_sources.emplace_back();
+    std::vector<gl::scene::mesh::vertex_region> vertex_regions;
+    gl::scene::mesh::index_region index_region;
 
     if (!geom_subset.positions.data.empty()) {
-        utils::fill_vao(geom_subset.positions, vao, 0);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.positions, vao, 0, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.tex_coords0.data.empty()) {
-        utils::fill_vao(geom_subset.tex_coords0, vao, 1);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.tex_coords0, vao, 1, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.normals.data.empty()) {
-        utils::fill_vao(geom_subset.normals, vao, 2);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.normals, vao, 2, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.tangents.data.empty()) {
-        utils::fill_vao(geom_subset.tangents, vao, 3);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.tangents, vao, 3, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.joints.data.empty()) {
-        utils::fill_vao(geom_subset.joints, vao, 4);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.joints, vao, 4, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.weights.data.empty()) {
-        utils::fill_vao(geom_subset.weights, vao, 5);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.weights, vao, 5, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.tex_coords1.data.empty()) {
-        utils::fill_vao(geom_subset.tex_coords1, vao, 6);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.tex_coords1, vao, 6, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.vertices_colors.data.empty()) {
-        utils::fill_vao(geom_subset.vertices_colors, vao, 7);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.vertices_colors, vao, 7, gl_scene.vertex_arena));
     }
 
     uint32_t i_size = 0;
     gl::scene::mesh::indices_type i_type = gl::scene::mesh::indices_type::none;
 
     if (!geom_subset.indices.data.empty()) {
-        gl::buffer<GL_ELEMENT_ARRAY_BUFFER> ebo;
-
-        auto fill_ebo = [&vao, &ebo, &i_size](auto& idata, const data_storage& orig_idata_storage) {
-            ebo.fill(idata.data(), idata.size() * sizeof(idata.front()));
+        auto fill_ebo = [&gl_scene, &vao, &index_region, &i_size](auto& idata, const data_storage& orig_idata_storage) {
+            index_region = utils::fill_ebo(idata.data(), idata.size() * sizeof(idata.front()), vao, gl_scene.index_arena);
             i_size = idata.size() * sizeof(idata.front());
         };
 
@@ -227,11 +231,6 @@ void gltf::adj_mesh_builder::make_subset(gl::scene::scene& gl_scene, gltf::mesh:
                 throw std::runtime_error("invalid index type.");
         }
 
-        vao.bind();
-        ebo.bind();
-        vao.unbind();
-        ebo.unbind();
-
         const auto el_size = utils::get_element_size(geom_subset.indices.c_type);
         assert(geom_subset.indices.d_type == gltf::data_storage::type::scalar);
         i_size = i_size / el_size;
@@ -241,6 +240,6 @@ void gltf::adj_mesh_builder::make_subset(gl::scene::scene& gl_scene, gltf::mesh:
     const auto el_count = utils::get_elements_count(geom_subset.positions.d_type);
     const auto pos_size = geom_subset.positions.data.size() / (el_size * el_count);
 
-    gl_scene.meshes.emplace_back(gl_scene.vertex_sources.size() - 1, i_type, i_size, pos_size);
-    assert(glGetError() == GL_NO_ERROR);
+    gl_scene.meshes.emplace_back(gl_scene.vertex_sources.size() - 1, i_type, i_size, pos_size, std::move(vertex_regions), index_region);
+    GL_CHECK_ERRORS();
 }
@@ -0,0 +1,165 @@
+
+
+#include "animation.hpp"
+
+#include <gltf/misc/acessor_utils.hpp>
+#include <gltf/misc/vertex_utils.hpp>
+
+#include <third/tinygltf/tiny_gltf.h>
+
+#include <algorithm>
+#include <cmath>
+
+
+gltf::animation::animation(const tinygltf::Model& model, const tinygltf::Animation& animation)
+    : m_name(animation.name)
+{
+    for (const auto& anim_channel : animation.channels) {
+        if (anim_channel.target_node < 0) {
+            continue;
+        }
+
+        const auto& sampler = animation.samplers.at(anim_channel.sampler);
+        auto& curr_channel = m_channels.emplace_back();
+        curr_channel.node = anim_channel.target_node;
+
+        if (anim_channel.target_path == "translation") {
+            curr_channel.target = channel::path::translation;
+        } else if (anim_channel.target_path == "rotation") {
+            curr_channel.target = channel::path::rotation;
+        } else if (anim_channel.target_path == "scale") {
+            curr_channel.target = channel::path::scale;
+        } else if (anim_channel.target_path == "weights") {
+            curr_channel.target = channel::path::weights;
+        } else {
+            m_channels.pop_back();
+            continue;
+        }
+
+        if (sampler.interpolation == "STEP") {
+            curr_channel.interp = channel::interpolation::step;
+        } else if (sampler.interpolation == "CUBICSPLINE") {
+            curr_channel.interp = channel::interpolation::cubic_spline;
+        } else {
+            curr_channel.interp = channel::interpolation::linear;
+        }
+
+        utils::copy_buffer_data([](float& data) { return &data; }, curr_channel.times, model, sampler.input);
+
+        data_storage values;
+        utils::copy_buffer_bytes(values, model, sampler.output);
+
+        // rotations and weights may be normalized integers (KHR_mesh_quantization), they are decoded to floats.
+        if (values.c_type == data_storage::component_type::f32) {
+            curr_channel.values.resize(values.data.size() / sizeof(float));
+            std::memcpy(curr_channel.values.data(), values.data.data(), values.data.size());
+        } else if (values.normalized && values.c_type != data_storage::component_type::u32) {
+            curr_channel.values.resize(values.data.size() / utils::get_element_size(values.c_type));
+
+            for (size_t i = 0; i < curr_channel.values.size(); ++i) {
+                curr_channel.values[i] = utils::read_component(values, i);
+            }
+        } else {
+            throw std::runtime_error("unsupported animation values type.");
+        }
+
+        const auto keys_count = curr_channel.times.size();
+        const auto values_per_key = curr_channel.interp == channel::interpolation::cubic_spline ? 3 : 1;
+        curr_channel.components = keys_count > 0 ? curr_channel.values.size() / (keys_count * values_per_key) : 0;
+
+        // cubic spline keys store in tangent, value, out tangent. only values are kept, keys are sampled linearly.
+        if (curr_channel.interp == channel::interpolation::cubic_spline) {
+            const auto components = curr_channel.components;
+            for (size_t key = 0; key < keys_count; ++key) {
+                std::memmove(
+                    curr_channel.values.data() + key * components,
+                    curr_channel.values.data() + (key * 3 + 1) * components,
+                    components * sizeof(float));
+            }
+            curr_channel.values.resize(keys_count * components);
+            curr_channel.interp = channel::interpolation::linear;
+        }
+
+        if (!curr_channel.times.empty()) {
+            m_duration = std::max(m_duration, curr_channel.times.back());
+        }
+    }
+}
+
+
+const std::string& gltf::animation::get_name() const
+{
+    return m_name;
+}
+
+
+float gltf::animation::get_duration() const
+{
+    return m_duration;
+}
+
+
+const std::vector<gltf::animation::channel>& gltf::animation::get_channels() const
+{
+    return m_channels;
+}
+
+
+void gltf::animation::sample(const gltf::animation::channel& channel, float t, float* dst)
+{
+    const auto components = channel.components;
+    const auto& times = channel.times;
+
+    if (times.empty()) {
+        return;
+    }
+
+    const auto next_key_it = std::upper_bound(times.begin(), times.end(), t);
+
+    if (next_key_it == times.begin() || next_key_it == times.end()) {
+        const size_t key = next_key_it == times.begin() ? 0 : times.size() - 1;
+        std::memcpy(dst, channel.values.data() + key * components, components * sizeof(float));
+        return;
+    }
+
+    const size_t next_key = next_key_it - times.begin();
+    const size_t prev_key = next_key - 1;
+    const float* prev_value = channel.values.data() + prev_key * components;
+    const float* next_value = channel.values.data() + next_key * components;
+
+    if (channel.interp == channel::interpolation::step) {
+        std::memcpy(dst, prev_value, components * sizeof(float));
+        return;
+    }
+
+    const float key_time = times[next_key] - times[prev_key];
+    const float factor = key_time > 0 ? (t - times[prev_key]) / key_time : 0;
+
+    if (channel.target == channel::path::rotation) {
+        // nlerp, keeps the shortest path.
+        float dot = 0;
+        for (uint32_t i = 0; i < 4; ++i) {
+            dot += prev_value[i] * next_value[i];
+        }
+
+        const float sign = dot < 0 ? -1 : 1;
+        float length = 0;
+
+        for (uint32_t i = 0; i < 4; ++i) {
+            dst[i] = prev_value[i] + (next_value[i] * sign - prev_value[i]) * factor;
+            length += dst[i] * dst[i];
+        }
+
+        length = length > 0 ? 1.f / std::sqrt(length) : 1.f;
+
+        for (uint32_t i = 0; i < 4; ++i) {
+            dst[i] *= length;
+        }
+
+        return;
+    }
+
+    for (uint32_t i = 0; i < components; ++i) {
+        dst[i] = prev_value[i] + (next_value[i] - prev_value[i]) * factor;
+    }
+}
@@ -0,0 +1,62 @@
+
+
+#pragma once
+
+#include <glm/vec4.hpp>
+
+#include <string>
+#include <vector>
+
+namespace tinygltf
+{
+    class Model;
+    struct Animation;
+} // namespace tinygltf
+
+namespace gltf
+{
+    class animation
+    {
+    public:
+        struct channel
+        {
+            enum class path
+            {
+                translation,
+                rotation,
+                scale,
+                weights
+            };
+
+            enum class interpolation
+            {
+                step,
+                linear,
+                cubic_spline
+            };
+
+            uint32_t node;
+            channel::path target;
+            channel::interpolation interp;
+            // values per key, 3 for translation and scale, 4 for rotation, targets count for weights.
+            uint32_t components;
+            std::vector<float> times;
+            std::vector<float> values;
+        };
+
+        animation(const tinygltf::Model& model, const tinygltf::Animation& animation);
+        ~animation() = default;
+
+        const std::string& get_name() const;
+        float get_duration() const;
+        const std::vector<channel>& get_channels() const;
+
+        // writes components values of the channel at time t into dst.
+        static void sample(const channel& channel, float t, float* dst);
+
+    private:
+        std::string m_name;
+        float m_duration{0};
+        std::vector<channel> m_channels;
+    };
+} // namespace gltf
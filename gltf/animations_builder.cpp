@@ -0,0 +1,3 @@
+
+
+#include "animations_builder.hpp"
@@ -0,0 +1,18 @@
+
+
+#pragma once
+
+#include <gl/scene/scene.hpp>
+#include <gltf/mesh.hpp>
+#include <gltf/skin.hpp>
+
+namespace gltf
+{
+    class animations_builder
+    {
+    public:
+        virtual ~animations_builder() = default;
+        virtual void make_animation(gl::scene::scene& gl_scene, const skin& skin) = 0;
+        virtual void bind_animation(gl::scene::scene& gl_scene, gl::scene::material& material, const mesh& mesh, const mesh::geom_subset& subset) = 0;
+    };
+} // namespace gltf
@@ -26,9 +26,6 @@ void gltf::camera::update(float w, float h)
 #endif
     m_view_matrix = glm::lookAt(m_position, m_direction, {0, 1, 0});
 
-    auto& proj_param = m_scene.parameters.at(m_scene_proj_idx);
-    auto& view_param = m_scene.parameters.at(m_scene_view_idx);
-
-    std::memcpy(proj_param.get_data(), glm::value_ptr(m_proj_matrix), sizeof(m_proj_matrix));
-    std::memcpy(view_param.get_data(), glm::value_ptr(m_view_matrix), sizeof(m_view_matrix));
+    m_scene.parameters.set(m_scene_proj_idx, m_proj_matrix);
+    m_scene.parameters.set(m_scene_view_idx, m_view_matrix);
 }
@@ -0,0 +1,90 @@
+
+
+#include "common_animations_builder.hpp"
+
+#include <glm/gtc/type_ptr.hpp>
+
+
+gltf::common_animations_builder::common_animations_builder(texture_format format)
+    : m_format(format)
+{
+}
+
+
+void gltf::common_animations_builder::make_animation(gl::scene::scene& gl_scene, const gltf::skin& skin)
+{
+    const auto joints_count = uint32_t(skin.get_nodes().size());
+    const auto keys_count = uint32_t(skin.animations.size());
+
+    if (joints_count == 0 || keys_count == 0) {
+        m_skins_animations.emplace_back(-1);
+        return;
+    }
+
+    int32_t max_texture_size;
+    glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+
+    // every joint matrix takes four texels (one per column), every key takes one row.
+    const auto width = joints_count * 4;
+    const auto height = keys_count;
+
+    if (width > uint32_t(max_texture_size) || height > uint32_t(max_texture_size)) {
+        throw std::runtime_error("animation does not fit into texture.");
+    }
+
+    std::vector<float> texture_data;
+    texture_data.reserve(width * height * 4);
+
+    gl::scene::animation gl_animation;
+    gl_animation.joints_count = joints_count;
+
+    for (uint32_t key = 0; key < keys_count; ++key) {
+        const auto& curr_key = skin.animations[key];
+        assert(curr_key.keys.size() == joints_count);
+
+        for (const auto& joint_matrix : curr_key.keys) {
+            const auto matrix_ptr = glm::value_ptr(joint_matrix);
+            texture_data.insert(texture_data.end(), matrix_ptr, matrix_ptr + 16);
+        }
+
+        if (gl_animation.clips.empty() || gl_animation.clips.back().name != curr_key.name) {
+            auto& clip = gl_animation.clips.emplace_back();
+            clip.name = curr_key.name;
+            clip.first_key = key;
+        }
+
+        ++gl_animation.clips.back().keys_count;
+    }
+
+    gl::texture<GL_TEXTURE_2D> tex(GL_NEAREST);
+    tex.fill(texture_data.data(), width, height, 4, m_format == texture_format::rgba16f);
+
+    gl_scene.textures.emplace_back(std::move(tex));
+    gl_animation.texture_idx = gl_scene.textures.size() - 1;
+
+    gl_scene.animations.emplace_back(std::move(gl_animation));
+    m_skins_animations.emplace_back(gl_scene.animations.size() - 1);
+}
+
+
+void gltf::common_animations_builder::bind_animation(
+    gl::scene::scene& gl_scene,
+    gl::scene::material& material,
+    const gltf::mesh& mesh,
+    const gltf::mesh::geom_subset& subset)
+{
+    const auto skin_index = mesh.get_skin_index();
+
+    if (skin_index < 0 || subset.joints.data.empty() || subset.weights.data.empty()) {
+        return;
+    }
+
+    const auto animation_index = m_skins_animations.at(skin_index);
+
+    if (animation_index < 0) {
+        return;
+    }
+
+    material.add_texture("s_anim", gl_scene.animations.at(animation_index).texture_idx);
+    material.set_animation(animation_index);
+}
@@ -0,0 +1,28 @@
+
+
+#pragma once
+
+#include <gltf/animations_builder.hpp>
+
+namespace gltf
+{
+    class common_animations_builder : public animations_builder
+    {
+    public:
+        enum class texture_format
+        {
+            rgba16f,
+            rgba32f
+        };
+
+        explicit common_animations_builder(texture_format format = texture_format::rgba32f);
+        ~common_animations_builder() override = default;
+
+        void make_animation(gl::scene::scene& gl_scene, const skin& skin) override;
+        void bind_animation(gl::scene::scene& gl_scene, gl::scene::material& material, const mesh& mesh, const mesh::geom_subset& subset) override;
+
+    private:
+        texture_format m_format;
+        std::vector<int32_t> m_skins_animations;
+    };
+} // namespace gltf
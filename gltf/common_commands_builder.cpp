@@ -2,31 +2,26 @@
 
 #include "common_commands_builder.hpp"
 
+#include <gl/scene/render_graph.hpp>
 
-void gltf::common_commands_builder::make_render_commands(gl::scene::scene& scene)
-{
-    scene.textures.emplace_back(gl::texture<GL_TEXTURE_2D>{}); // color attachment texture
-    const auto color_attachment_idx = scene.textures.size() - 1;
-    scene.textures.emplace_back(gl::texture<GL_TEXTURE_2D>{}); // depth attachment texture
-    const auto depth_attachment_idx = scene.textures.size() - 1;
-
-    auto& a = scene.attachments.emplace_back(scene, color_attachment_idx, gl::scene::attachment_type::rgba8);
-    float clear_vals[] {0, 1, 0, 1};
-    a.set_clear_values(clear_vals);
-    scene.attachments.emplace_back(scene, depth_attachment_idx, gl::scene::attachment_type::depth24f);
+#include <numeric>
 
-    scene.fbos.emplace_back();
 
-    auto& fb = scene.framebuffers.emplace_back(scene, scene.fbos.size() - 1, 1600, 1200);
-
-    fb.add_attachment(fb.color1, 0);
-    fb.add_attachment(fb.depth, 1);
+void gltf::common_commands_builder::make_render_commands(gl::scene::scene& scene)
+{
+    gl::scene::render_graph graph;
 
-    scene.passes.emplace_back(scene, scene.framebuffers.size() - 1);
+    const auto color = graph.create_attachment("color", {gl::scene::attachment_type::rgba8, 1600, 1200, {0, 1, 0, 1}});
+    const auto depth = graph.create_attachment("depth", {gl::scene::attachment_type::depth24f, 1600, 1200});
 
-    scene.commands.emplace_back(gl::scene::render_command {gl::scene::render_command::type::pass, 0});
+    gl::scene::render_graph::pass_desc main_pass;
+    main_pass.name = "main";
+    main_pass.color_writes = {color};
+    main_pass.depth_write = depth;
+    main_pass.drawables.resize(scene.drawables.size());
+    std::iota(main_pass.drawables.begin(), main_pass.drawables.end(), 0);
 
-    for (uint32_t i = 0; i < scene.drawables.size(); ++i) {
-        scene.commands.emplace_back(gl::scene::render_command {gl::scene::render_command::type::draw, i});
-    }
+    graph.add_pass(std::move(main_pass));
+    graph.set_output(color);
+    graph.compile(scene);
 }
@@ -2,11 +2,17 @@
 
 #include "common_material_builder.hpp"
 
-#include <shaders.hpp>
+#include <gltf/pbr_features.hpp>
 #include <assimp_handlers.hpp>
 
 #include <third/tinygltf/tiny_gltf.h>
 
+gltf::common_material_builder::common_material_builder(bool skinning)
+    : m_skinning(skinning)
+{
+}
+
+
 uint32_t gltf::common_material_builder::make_material(
     gl::scene::scene& gl_scene,
     const tinygltf::Model& model,
@@ -25,8 +31,13 @@ uint32_t gltf::common_material_builder::make_material(
 
     const auto& mat = model.materials.at(subset.material);
 
-    gl_scene.shaders.emplace_back(gl::shader<GL_VERTEX_SHADER>{shaders::pbr_vss}, gl::shader<GL_FRAGMENT_SHADER>{shaders::pbr_fss_ibl});
-    auto& gl_mat = gl_scene.materials.emplace_back(gl_scene.shaders.size() - 1);
+    // subsets with the same features share a program, it is compiled in the background after the first draw
+    // and the subset is drawn with the variant of fallback features until then.
+    const auto features = get_pbr_features(model, subset, m_skinning);
+    const auto fallback = gl_scene.programs.get_program(gl_scene.shaders, make_pbr_sources(features & pbr_fallback_features));
+    const auto program = gl_scene.programs.get_program(gl_scene.shaders, make_pbr_sources(features), fallback);
+    auto& gl_mat = gl_scene.materials.emplace_back(program);
+    gl_mat.set_name(mat.name);
 
     gl_mat.set_state({
         {true, true, true, true},
@@ -38,7 +49,7 @@ uint32_t gltf::common_material_builder::make_material(
     add_texture("s_albedo", gl_mat, mat.pbrMetallicRoughness.baseColorTexture);
     add_texture("s_metallic_roughness", gl_mat, mat.pbrMetallicRoughness.metallicRoughnessTexture);
     add_texture("s_normal", gl_mat, mat.normalTexture);
-    add_texture("s_emissve", gl_mat, mat.emissiveTexture);
+    add_texture("s_emissive", gl_mat, mat.emissiveTexture);
     add_texture("s_occlusion", gl_mat, mat.occlusionTexture);
 
     return gl_scene.materials.size() - 1;
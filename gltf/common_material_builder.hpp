@@ -10,7 +10,11 @@ namespace gltf
     class common_material_builder : public material_builder
     {
     public:
+        // skinning off for subsets skinned on the cpu, see common_mesh_builder.
+        explicit common_material_builder(bool skinning = true);
         uint32_t make_material(gl::scene::scene& gl_scene, const tinygltf::Model& model, const mesh::geom_subset& subset) override;
+    private:
+        bool m_skinning;
     };
 }
 
@@ -3,79 +3,142 @@
 #include "common_mesh_builder.hpp"
 
 #include <gltf/misc/gl_vao_utils.hpp>
+#include <gltf/misc/vertex_utils.hpp>
+
+#include <algorithm>
 
 
 void gltf::common_mesh_builder::make_mesh(const gltf::mesh& mesh, gl::scene::scene& scene)
 {
     for (const auto& geom_subset : mesh.get_geom_subsets()) {
         make_subset(scene, geom_subset);
+        scene.meshes.back().set_name(mesh.get_name());
+        scene.meshes.back().set_bounds(utils::get_bounds(geom_subset));
     }
 }
 
 
-std::unique_ptr<gltf::common_mesh_builder> gltf::common_mesh_builder::create()
+std::unique_ptr<gltf::common_mesh_builder> gltf::common_mesh_builder::create(bool cpu_skinning)
+{
+    return std::make_unique<gltf::common_mesh_builder>(cpu_skinning);
+}
+
+
+gltf::common_mesh_builder::common_mesh_builder(bool cpu_skinning)
+    : m_cpu_skinning(cpu_skinning)
 {
-    return std::make_unique<gltf::common_mesh_builder>();
 }
 
 
 void gltf::common_mesh_builder::make_subset(gl::scene::scene& gl_scene, const gltf::mesh::geom_subset geom_subset)
 {
+    if (utils::is_pooled(geom_subset, m_cpu_skinning)) {
+        make_pooled_subset(gl_scene, geom_subset);
+        return;
+    }
+
     auto& vao = gl_scene.vertex_sources.emplace_back();
+    std::vector<gl::scene::mesh::vertex_region> vertex_regions;
 
     if (!geom_subset.positions.data.empty()) {
-        utils::fill_vao(geom_subset.positions, vao, 0);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.positions, vao, 0, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.tex_coords0.data.empty()) {
-        utils::fill_vao(geom_subset.tex_coords0, vao, 1);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.tex_coords0, vao, 1, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.normals.data.empty()) {
-        utils::fill_vao(geom_subset.normals, vao, 2);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.normals, vao, 2, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.tangents.data.empty()) {
-        utils::fill_vao(geom_subset.tangents, vao, 3);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.tangents, vao, 3, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.joints.data.empty()) {
-        utils::fill_vao(geom_subset.joints, vao, 4);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.joints, vao, 4, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.weights.data.empty()) {
-        utils::fill_vao(geom_subset.weights, vao, 5);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.weights, vao, 5, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.tex_coords1.data.empty()) {
-        utils::fill_vao(geom_subset.tex_coords1, vao, 6);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.tex_coords1, vao, 6, gl_scene.vertex_arena));
     }
 
     if (!geom_subset.vertices_colors.data.empty()) {
-        utils::fill_vao(geom_subset.vertices_colors, vao, 7);
+        vertex_regions.emplace_back(utils::fill_vao(geom_subset.vertices_colors, vao, 7, gl_scene.vertex_arena));
     }
 
     uint32_t i_size = 0;
     gl::scene::mesh::indices_type i_type = gl::scene::mesh::indices_type::none;
+    gl::scene::mesh::index_region index_region;
 
-    if (geom_subset.indices.data.size() > 0) {
-        gl::buffer<GL_ELEMENT_ARRAY_BUFFER> ebo;
-        ebo.fill(geom_subset.indices.data.data(), geom_subset.indices.data.size());
+    if (!geom_subset.indices.data.empty()) {
+        index_region = utils::fill_ebo(geom_subset.indices.data.data(), geom_subset.indices.data.size(), vao, gl_scene.index_arena);
+        i_type = static_cast<gl::scene::mesh::indices_type>(geom_subset.indices.c_type);
+        i_size = utils::get_vertices_count(geom_subset.indices);
+    }
 
-        vao.bind();
-        ebo.bind();
-        vao.unbind();
-        ebo.unbind();
+    const auto pos_size = utils::get_vertices_count(geom_subset.positions);
 
-        const auto el_size = utils::get_element_size(geom_subset.indices.c_type);
-        const auto el_count = utils::get_elements_count(geom_subset.indices.d_type);
-        i_type = static_cast<gl::scene::mesh::indices_type>(geom_subset.indices.c_type);
-        i_size = geom_subset.indices.data.size() / (el_size * el_count);
+    gl_scene.meshes.emplace_back(gl_scene.vertex_sources.size() - 1, i_type, i_size, pos_size, std::move(vertex_regions), index_region);
+}
+
+
+void gltf::common_mesh_builder::make_pooled_subset(gl::scene::scene& gl_scene, const gltf::mesh::geom_subset& geom_subset)
+{
+    constexpr uint32_t pool_vertices = 256 * 1024;
+    constexpr uint32_t pool_indices = 1024 * 1024;
+    constexpr uint32_t pool_slots = 4096;
+
+    const std::pair<const data_storage*, int32_t> attributes[]{
+        {&geom_subset.positions, 0},
+        {&geom_subset.tex_coords0, 1},
+        {&geom_subset.normals, 2},
+        {&geom_subset.tangents, 3},
+        {&geom_subset.joints, 4},
+        {&geom_subset.weights, 5},
+        {&geom_subset.tex_coords1, 6},
+        {&geom_subset.vertices_colors, 7}};
+
+    std::vector<gl::scene::vertex_attribute> format;
+    std::vector<const void*> attributes_data;
+
+    for (const auto& [ds, location] : attributes) {
+        if (ds->data.empty()) {
+            continue;
+        }
+
+        format.emplace_back(gl::scene::vertex_attribute{location, utils::get_elements_count(ds->d_type), uint32_t(ds->c_type), ds->normalized});
+        attributes_data.emplace_back(ds->data.data());
     }
 
-    const auto el_size = utils::get_element_size(geom_subset.positions.c_type);
-    const auto el_count = utils::get_elements_count(geom_subset.positions.d_type);
-    const auto pos_size = geom_subset.positions.data.size() / (el_size * el_count);
+    const auto vertices_count = utils::get_vertices_count(geom_subset.positions);
+    const auto indices_count = utils::get_vertices_count(geom_subset.indices);
+    const auto indices_type = uint32_t(geom_subset.indices.c_type);
+
+    auto pool = std::find_if(gl_scene.vertex_pools.begin(), gl_scene.vertex_pools.end(), [&](const gl::scene::vertex_pool& p) {
+        return p.is_compatible(format, indices_type) && p.can_fit(vertices_count, indices_count);
+    });
+
+    if (pool == gl_scene.vertex_pools.end()) {
+        gl_scene.vertex_pools.emplace_back(
+            gl_scene, format, indices_type, std::max(pool_vertices, uint32_t(vertices_count)), std::max(pool_indices, uint32_t(indices_count)), pool_slots);
+        pool = gl_scene.vertex_pools.end() - 1;
+    }
 
-    gl_scene.meshes.emplace_back(gl_scene.vertex_sources.size() - 1, i_type, i_size, pos_size);
+    const auto allocation = pool->append(gl_scene, attributes_data, vertices_count, geom_subset.indices.data.data(), indices_count);
+
+    gl_scene.meshes.emplace_back(
+        pool->get_vertex_source(),
+        static_cast<gl::scene::mesh::indices_type>(indices_type),
+        indices_count,
+        vertices_count,
+        int32_t(pool - gl_scene.vertex_pools.begin()),
+        allocation.base_vertex,
+        allocation.indices_offset,
+        allocation.slot);
 }
@@ -11,12 +11,16 @@ namespace gltf
     class common_mesh_builder : public mesh_builder
     {
     public:
-        static std::unique_ptr<common_mesh_builder> create();
-        common_mesh_builder() = default;
+        // skinned subsets stay out of vertex pools with cpu skinning, see utils::is_pooled.
+        static std::unique_ptr<common_mesh_builder> create(bool cpu_skinning = false);
+        explicit common_mesh_builder(bool cpu_skinning = false);
         ~common_mesh_builder() override = default;
         void make_mesh(const mesh& mesh, gl::scene::scene& scene) override;
     private:
         void make_subset(gl::scene::scene&, const mesh::geom_subset subset);
+        void make_pooled_subset(gl::scene::scene&, const mesh::geom_subset& subset);
+
+        bool m_cpu_skinning;
     };
 }
 
@@ -24,13 +24,42 @@ uniform mat4 u_VIEW;
 uniform mat4 u_MODEL;
 uniform mat4 u_PROJECTION;
 
+#ifdef ANIM
+uniform sampler2D s_anim;
+uniform int u_ANIM_KEY;
+
+mat4 get_anim_matrix(int bone_idx, int key)
+{
+    vec4 x = texelFetch(s_anim, ivec2(bone_idx, key), 0);
+    vec4 y = texelFetch(s_anim, ivec2(bone_idx + 1, key), 0);
+    vec4 z = texelFetch(s_anim, ivec2(bone_idx + 2, key), 0);
+    vec4 w = texelFetch(s_anim, ivec2(bone_idx + 3, key), 0);
+    return mat4(x, y, z, w);
+}
+
+mat4 get_anim_transform(int key)
+{
+    mat4 m1 = get_anim_matrix(int(attr_bones.x) * 4, key) * attr_weights.x;
+    mat4 m2 = get_anim_matrix(int(attr_bones.y) * 4, key) * attr_weights.y;
+    mat4 m3 = get_anim_matrix(int(attr_bones.z) * 4, key) * attr_weights.z;
+    mat4 m4 = get_anim_matrix(int(attr_bones.w) * 4, key) * attr_weights.w;
+
+    return m1 + m2 + m3 + m4;
+}
+#endif
+
 const float PI = 3.14159265;
 
 void main()
 {
     mat4 model_transform = u_MODEL;
 
+#ifdef ANIM
+    mat4 anim_transform = get_anim_transform(u_ANIM_KEY);
+    vec3 v = vec3(anim_transform * vec4(attr_pos, 1.));
+#else
     vec3 v = attr_pos.xyz;
+#endif
 //    gl_Position = u_MVP * vec4(v, 1.);
    gl_Position = vec4(v, 1.);
 
@@ -44,8 +73,13 @@ void main()
 //    v_uv = attr_uv;
 //    v_view_pos = (u_VIEW)[3].xyz;
 
+#ifdef ANIM
+    v_n = vec3(anim_transform * vec4(attr_normal, 0.));
+    v_t = vec3(anim_transform * vec4(attr_tangent, 0.));
+#else
     v_n = attr_normal;
     v_t = attr_tangent;
+#endif
 //    v_b = cross(v_n, v_t);
 
 //    v_v = vec3(u_MODEL * vec4(v, 1.));
@@ -143,6 +177,12 @@ void main()
 }
 
 
+gltf::custom_material_builder::custom_material_builder(bool skinning)
+    : m_skinning(skinning)
+{
+}
+
+
 uint32_t gltf::custom_material_builder::make_material(
     gl::scene::scene& gl_scene,
     const tinygltf::Model& model,
@@ -163,8 +203,12 @@ uint32_t gltf::custom_material_builder::make_material(
 
 //    gl_scene.textures.emplace_back(std::move(tex));
 
-    gl_scene.shaders.emplace_back(gl::shader<GL_VERTEX_SHADER>{vss}, gl::shader<GL_FRAGMENT_SHADER>{fss}, gl::shader<GL_GEOMETRY_SHADER>(gss));
-    auto& gl_mat = gl_scene.materials.emplace_back(gl_scene.shaders.size() - 1);
+    // skinned subsets get the ANIM variant, it reads the joint matrices of u_ANIM_KEY from s_anim.
+    const bool is_skinned = m_skinning && !subset.joints.data.empty() && !subset.weights.data.empty();
+    const auto program = gl_scene.programs.get_program(
+        gl_scene.shaders,
+        {is_skinned ? gl::add_defines(vss, {"ANIM"}) : vss, fss, gss});
+    auto& gl_mat = gl_scene.materials.emplace_back(program);
 
     gl_mat.set_state({
      {true, true, true, true},
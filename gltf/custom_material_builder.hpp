@@ -10,7 +10,13 @@ namespace gltf
     class custom_material_builder : public material_builder
     {
     public:
+        // skinned subsets get the ANIM variant unless skinning is off, e.g. when they are skinned on the cpu.
+        explicit custom_material_builder(bool skinning = true);
+
         uint32_t make_material(gl::scene::scene& gl_scene, const tinygltf::Model& model, const mesh::geom_subset& subset) override;
+
+    private:
+        bool m_skinning;
     };
 }
 
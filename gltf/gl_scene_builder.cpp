@@ -13,13 +13,15 @@ gltf::gl_scene_builder::gl_scene_builder(
     std::unique_ptr<parameters_builder> parameters_builder,
     std::unique_ptr<images_builder> images_builder,
     std::unique_ptr<drawables_builder> drawables_builder,
-    std::unique_ptr<commands_builder> commands_builder)
+    std::unique_ptr<commands_builder> commands_builder,
+    std::unique_ptr<animations_builder> animations_builder)
     : m_mesh_builder(std::move(mesh_builder))
     , m_material_builder(std::move(material_builder))
     , m_params_builder(std::move(parameters_builder))
     , m_images_builder(std::move(images_builder))
     , m_drawables_builder(std::move(drawables_builder))
     , m_commands_builder(std::move(commands_builder))
+    , m_animations_builder(std::move(animations_builder))
 {
 }
 
@@ -33,6 +35,7 @@ void gltf::gl_scene_builder::build_scene(
 {
     make_images(gl_scene, model);
     make_meshes(gl_scene, meshes);
+    make_animations(gl_scene, skins);
     make_materials(gl_scene, model, meshes);
     make_environment(gl_scene, env_texture_path);
     m_drawables_builder->make_drawables(gl_scene, meshes);
@@ -59,11 +62,20 @@ void gltf::gl_scene_builder::make_materials(
         for (const auto& subset : mesh.get_geom_subsets()) {
             const auto mat_index = m_material_builder->make_material(gl_scene, model, subset);
             m_params_builder->make_parameters(gl_scene, gl_scene.materials.at(mat_index), subset);
+            m_animations_builder->bind_animation(gl_scene, gl_scene.materials.at(mat_index), mesh, subset);
         }
     }
 }
 
 
+void gltf::gl_scene_builder::make_animations(gl::scene::scene& gl_scene, const std::vector<skin>& skins)
+{
+    for (const auto& skin : skins) {
+        m_animations_builder->make_animation(gl_scene, skin);
+    }
+}
+
+
 void gltf::gl_scene_builder::make_images(gl::scene::scene& gl_scene, const tinygltf::Model& model)
 {
     for (const auto& img : model.images) {
@@ -114,6 +126,7 @@ void gltf::gl_scene_builder::make_environment(
         drawable.topo = gl::scene::drawable::topology::triangles;
         drawable.mesh_idx = gl_scene.meshes.size() - 1;
         drawable.material_idx = gl_scene.materials.size() - 1;
+        drawable.background = true;
     }
 
     for (auto& mat : gl_scene.materials) {
@@ -11,6 +11,7 @@
 #include <gltf/images_builder.hpp>
 #include <gltf/drawables_builder.hpp>
 #include <gltf/commands_builder.hpp>
+#include <gltf/animations_builder.hpp>
 
 
 
@@ -33,7 +34,8 @@ namespace gltf
             std::unique_ptr<parameters_builder>,
             std::unique_ptr<images_builder>,
             std::unique_ptr<drawables_builder>,
-            std::unique_ptr<commands_builder>);
+            std::unique_ptr<commands_builder>,
+            std::unique_ptr<animations_builder>);
 
         void build_scene(
             gl::scene::scene& gl_scene,
@@ -46,6 +48,7 @@ namespace gltf
         void make_images(gl::scene::scene& gl_scene, const tinygltf::Model& model);
         void make_meshes(gl::scene::scene& gl_scene, const std::vector<mesh>& meshes);
         void make_materials(gl::scene::scene& gl_scene, const tinygltf::Model& model, const std::vector<mesh>& meshes);
+        void make_animations(gl::scene::scene& gl_scene, const std::vector<skin>& skins);
         void make_environment(gl::scene::scene& gl_scene, const std::string& env_texture_path);
 
         std::unique_ptr<mesh_builder> m_mesh_builder;
@@ -54,6 +57,7 @@ namespace gltf
         std::unique_ptr<images_builder> m_images_builder;
         std::unique_ptr<drawables_builder> m_drawables_builder;
         std::unique_ptr<commands_builder> m_commands_builder;
+        std::unique_ptr<animations_builder> m_animations_builder;
 
     };
 }
@@ -2,6 +2,7 @@
 
 #include "gltf_graph.hpp"
 
+#include <gl/profiler.hpp>
 #include <third/tinygltf/tiny_gltf.h>
 
 
@@ -18,6 +19,8 @@ gltf::scene_graph::~scene_graph() = default;
 
 void gltf::scene_graph::update()
 {
+    gl::cpu_zone zone("scene_graph::update");
+
     for_each_node(m_root, [](std::shared_ptr<node>& node) {
         auto parent_ptr = node->m_parent.lock();
         if (parent_ptr != nullptr) {
@@ -139,3 +142,9 @@ uint32_t gltf::scene_graph::node::get_node_index() const
 {
     return m_node_index;
 }
+
+
+std::shared_ptr<gltf::scene_graph::node> gltf::scene_graph::node::get_parent() const
+{
+    return m_parent.lock();
+}
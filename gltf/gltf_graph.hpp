@@ -36,6 +36,7 @@ namespace gltf
             glm::mat4 get_local_transformation() const;
             glm::mat4 get_global_transformation() const;
             uint32_t get_node_index() const;
+            std::shared_ptr<node> get_parent() const;
 
         private:
             glm::mat4 m_world_matrix{1.};
@@ -36,10 +36,17 @@ void gltf::gltf_parser::parse(const std::string& path, const std::string& env_pa
         throw std::runtime_error(err_msg);
     }
 
-    gltf::meshes_processor mesh_processor;
-    mesh_processor.m_model = &mdl;
-    mesh_processor.process_meshes(scene_index);
-    m_builder.build_scene(gl_scene, mesh_processor.get_meshes(), mesh_processor.get_skins(), mdl, env_path);
+    m_processor = gltf::meshes_processor{};
+    m_processor.m_model = &mdl;
+    m_processor.m_skeleton_lods = m_skeleton_lods;
+    m_processor.process_meshes(scene_index);
+    m_builder.build_scene(gl_scene, m_processor.get_meshes(), m_processor.get_skins(), mdl, env_path);
+}
+
+
+const gltf::meshes_processor& gltf::gltf_parser::get_processor() const
+{
+    return m_processor;
 }
 
 
@@ -47,3 +54,9 @@ gltf::gltf_parser::gltf_parser(gltf::gl_scene_builder b)
     : m_builder(std::move(b))
 {
 }
+
+
+void gltf::gltf_parser::set_skeleton_lods(std::vector<skeleton_lod_builder::settings> lods)
+{
+    m_skeleton_lods = std::move(lods);
+}
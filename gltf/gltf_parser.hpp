@@ -15,8 +15,13 @@ namespace gltf
     public:
         gltf_parser(gl_scene_builder);
         void parse(const std::string& path, const std::string& env_path, gl::scene::scene& scene, uint32_t scene_index = 0);
+        const meshes_processor& get_processor() const;
+        void set_skeleton_lods(std::vector<skeleton_lod_builder::settings> lods);
+
     private:
         gl_scene_builder m_builder;
+        meshes_processor m_processor;
+        std::vector<skeleton_lod_builder::settings> m_skeleton_lods;
     };
 }
 
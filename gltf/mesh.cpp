@@ -3,12 +3,82 @@
 #include "mesh.hpp"
 
 #include <gltf/misc/acessor_utils.hpp>
+#include <gltf/misc/vertex_utils.hpp>
 #include <third/tinygltf/tiny_gltf.h>
 #include <iostream>
 
 
+namespace
+{
+    std::vector<glm::vec3> read_deltas(const tinygltf::Model& model, const std::map<std::string, int>& target, const char* attribute)
+    {
+        std::vector<glm::vec3> deltas;
+
+        if (const auto it = target.find(attribute); it != target.end()) {
+            gltf::data_storage ds;
+            gltf::utils::copy_buffer_bytes(ds, model, it->second);
+
+            const auto components_count = gltf::utils::get_elements_count(ds.d_type);
+            deltas.resize(gltf::utils::get_vertices_count(ds));
+
+            for (size_t i = 0; i < deltas.size(); ++i) {
+                for (size_t c = 0; c < 3; ++c) {
+                    deltas[i][c] = gltf::utils::read_component(ds, i * components_count + c);
+                }
+            }
+        }
+
+        return deltas;
+    }
+
+
+    gltf::mesh::geom_subset::morph_target make_morph_target(
+        const tinygltf::Model& model, const std::map<std::string, int>& target, size_t vertices_count)
+    {
+        const auto positions = read_deltas(model, target, "POSITION");
+        const auto normals = read_deltas(model, target, "NORMAL");
+        const auto tangents = read_deltas(model, target, "TANGENT");
+
+        const auto is_zero = [](const std::vector<glm::vec3>& deltas, size_t v) {
+            return deltas.empty() || (deltas[v].x == 0 && deltas[v].y == 0 && deltas[v].z == 0);
+        };
+
+        gltf::mesh::geom_subset::morph_target morph_target;
+
+        for (size_t v = 0; v < vertices_count; ++v) {
+            if (is_zero(positions, v) && is_zero(normals, v) && is_zero(tangents, v)) {
+                continue;
+            }
+
+            morph_target.vertices.emplace_back(v);
+
+            if (!positions.empty()) {
+                morph_target.positions.emplace_back(positions[v]);
+            }
+
+            if (!normals.empty()) {
+                morph_target.normals.emplace_back(normals[v]);
+            }
+
+            if (!tangents.empty()) {
+                morph_target.tangents.emplace_back(tangents[v]);
+            }
+        }
+
+        // keep attributes aligned with vertices even if the target does not move positions.
+        if (morph_target.positions.empty()) {
+            morph_target.positions.resize(morph_target.vertices.size(), glm::vec3{0});
+        }
+
+        return morph_target;
+    }
+} // namespace
+
+
 gltf::mesh::mesh(const tinygltf::Model& model, const tinygltf::Mesh& mesh, int32_t skin_index)
-    : m_skin_index(skin_index)
+    : m_name(mesh.name)
+    , m_skin_index(skin_index)
+    , m_weights(mesh.weights.begin(), mesh.weights.end())
 {
     for (const auto& primitive : mesh.primitives) {
         auto& curr_subset = m_geometry_subsets.emplace_back(primitive, model);
@@ -22,6 +92,31 @@ gltf::mesh::get_geom_subsets() const
     return m_geometry_subsets;
 }
 
+
+std::vector<gltf::mesh::geom_subset>& gltf::mesh::get_geom_subsets()
+{
+    return m_geometry_subsets;
+}
+
+
+int32_t gltf::mesh::get_skin_index() const
+{
+    return m_skin_index;
+}
+
+
+const std::vector<float>& gltf::mesh::get_weights() const
+{
+    return m_weights;
+}
+
+
+const std::string& gltf::mesh::get_name() const
+{
+    return m_name;
+}
+
+
 gltf::mesh::geom_subset::geom_subset(const tinygltf::Primitive& primitive, const tinygltf::Model& model)
     : topo(static_cast<mesh::topo>(primitive.mode))
     , material(primitive.material)
@@ -57,4 +152,11 @@ gltf::mesh::geom_subset::geom_subset(const tinygltf::Primitive& primitive, const
     if (primitive.indices >= 0) {
         utils::copy_buffer_bytes(indices, model, primitive.indices);
     }
+
+    const auto vertices_count = utils::get_vertices_count(positions);
+    morph_targets.reserve(primitive.targets.size());
+
+    for (const auto& target : primitive.targets) {
+        morph_targets.emplace_back(make_morph_target(model, target, vertices_count));
+    }
 }
\ No newline at end of file
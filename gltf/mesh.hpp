@@ -57,15 +57,43 @@ namespace gltf
             data_storage weights;
             data_storage indices;
 
+            // JOINTS_0 and WEIGHTS_0 remapped to the joints of every skin lod.
+            struct skin_lod
+            {
+                data_storage joints;
+                data_storage weights;
+            };
+
+            std::vector<skin_lod> skin_lods;
+
+            // morph target deltas, only displaced vertices are stored.
+            // normals and tangents are empty when the target does not define them.
+            struct morph_target
+            {
+                std::vector<uint32_t> vertices;
+                std::vector<glm::vec3> positions;
+                std::vector<glm::vec3> normals;
+                std::vector<glm::vec3> tangents;
+            };
+
+            std::vector<morph_target> morph_targets;
+
             uint32_t material;
         };
 
         mesh(const tinygltf::Model& model, const tinygltf::Mesh& mesh, int32_t skin_index);
         virtual ~mesh() = default;
         const std::vector<geom_subset>& get_geom_subsets() const;
+        std::vector<geom_subset>& get_geom_subsets();
+        int32_t get_skin_index() const;
+        // default morph targets weights.
+        const std::vector<float>& get_weights() const;
+        const std::string& get_name() const;
 
     private:
+        std::string m_name;
         int32_t m_skin_index;
+        std::vector<float> m_weights;
         std::vector<geom_subset> m_geometry_subsets;
     };
 }
@@ -3,6 +3,7 @@
 #include "meshes_processor.hpp"
 
 #include <gltf/misc/acessor_utils.hpp>
+#include <gltf/misc/vertex_utils.hpp>
 
 #include <glm/gtc/type_ptr.hpp>
 
@@ -106,12 +107,68 @@ void gltf::meshes_processor::process_meshes(uint32_t scene_index)
         return true;
     });
 
+    for (const auto& anim : m_model->animations) {
+        m_animations.emplace_back(*m_model, anim);
+    }
+
     calculate_animations();
+    calculate_joints_bounds();
+    make_skeleton_lods();
 
     m_model = nullptr;
 }
 
 
+void gltf::meshes_processor::calculate_joints_bounds()
+{
+    for (auto& skin : m_skins) {
+        skin.joints_bounds.assign(skin.get_joints().size(), ::utils::aabb{});
+    }
+
+    for (const auto& mesh : m_meshes) {
+        if (mesh.get_skin_index() < 0) {
+            continue;
+        }
+
+        auto& bounds = m_skins.at(mesh.get_skin_index()).joints_bounds;
+
+        for (const auto& subset : mesh.get_geom_subsets()) {
+            if (subset.joints.data.empty() || subset.weights.data.empty()) {
+                continue;
+            }
+
+            const auto vertices_bounds = utils::get_vertices_bounds(subset);
+
+            for (size_t v = 0; v < vertices_bounds.size(); ++v) {
+                uint32_t joints[4];
+                float weights[4];
+                utils::read_influences(subset.joints, subset.weights, v, joints, weights);
+
+                for (size_t i = 0; i < 4; ++i) {
+                    if (weights[i] > 0 && joints[i] < bounds.size()) {
+                        bounds[joints[i]].expand(vertices_bounds[v]);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+void gltf::meshes_processor::make_skeleton_lods()
+{
+    if (m_skeleton_lods.empty()) {
+        return;
+    }
+
+    skeleton_lod_builder builder(m_skeleton_lods);
+
+    for (size_t skin = 0; skin < m_skins.size(); ++skin) {
+        builder.make_lods(m_skins[skin], skin, m_meshes);
+    }
+}
+
+
 const std::vector<gltf::skin>& gltf::meshes_processor::get_skins() const
 {
     return m_skins;
@@ -124,6 +181,12 @@ const std::vector<gltf::mesh>& gltf::meshes_processor::get_meshes() const
 }
 
 
+const std::vector<gltf::animation>& gltf::meshes_processor::get_animations() const
+{
+    return m_animations;
+}
+
+
 void gltf::meshes_processor::calculate_animations()
 {
     std::vector<anim> anims;
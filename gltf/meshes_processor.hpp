@@ -6,6 +6,8 @@
 
 #include <gltf/skin.hpp>
 #include <gltf/mesh.hpp>
+#include <gltf/animation.hpp>
+#include <gltf/skeleton_lod_builder.hpp>
 
 
 namespace gltf
@@ -18,14 +20,19 @@ namespace gltf
         std::shared_ptr<scene_graph> get_graph() const;
         const std::vector<skin>& get_skins() const;
         const std::vector<mesh>& get_meshes() const;
+        const std::vector<animation>& get_animations() const;
 
     private:
         void process_meshes(uint32_t scene_index);
         void calculate_animations();
+        void make_skeleton_lods();
+        void calculate_joints_bounds();
 
         std::shared_ptr<scene_graph> m_graph;
         tinygltf::Model* m_model;
         std::vector<skin> m_skins;
         std::vector<mesh> m_meshes;
+        std::vector<animation> m_animations;
+        std::vector<skeleton_lod_builder::settings> m_skeleton_lods;
     };
 } // namespace gltf
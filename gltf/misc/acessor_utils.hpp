@@ -46,28 +46,79 @@ namespace gltf::utils
     }
 
 
+    inline void copy_sparse_bytes(data_storage& ds, const tinygltf::Model& mdl, const tinygltf::Accessor& accessor, size_t element_size)
+    {
+        const auto& sparse = accessor.sparse;
+
+        const auto& indices_view = mdl.bufferViews.at(sparse.indices.bufferView);
+        const auto indices_ptr = mdl.buffers.at(indices_view.buffer).data.data() + indices_view.byteOffset + sparse.indices.byteOffset;
+        const auto index_size = tinygltf::GetComponentSizeInBytes(sparse.indices.componentType);
+
+        const auto& values_view = mdl.bufferViews.at(sparse.values.bufferView);
+        const auto values_ptr = mdl.buffers.at(values_view.buffer).data.data() + values_view.byteOffset + sparse.values.byteOffset;
+
+        for (size_t i = 0; i < size_t(sparse.count); ++i) {
+            uint32_t index = 0;
+
+            switch (sparse.indices.componentType) {
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_BYTE:
+                    index = indices_ptr[i];
+                    break;
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_SHORT:
+                {
+                    uint16_t v;
+                    std::memcpy(&v, indices_ptr + i * index_size, sizeof(v));
+                    index = v;
+                    break;
+                }
+                case TINYGLTF_COMPONENT_TYPE_UNSIGNED_INT:
+                    std::memcpy(&index, indices_ptr + i * index_size, sizeof(index));
+                    break;
+                default:
+                    throw std::runtime_error("bad sparse indices type.");
+            }
+
+            if (index >= accessor.count) {
+                throw std::runtime_error("sparse index out of range.");
+            }
+
+            // sparse values are tightly packed.
+            std::memcpy(ds.data.data() + index * element_size, values_ptr + i * element_size, element_size);
+        }
+    }
+
+
     inline void copy_buffer_bytes(data_storage& ds, const tinygltf::Model& mdl, uint32_t accessor_idx)
     {
-        auto [data_accessor, data_b_view, data_buf, data_ptr, data_size] = get_buffer_data(mdl, accessor_idx);
+        const auto& data_accessor = mdl.accessors.at(accessor_idx);
         ds.c_type = static_cast<data_storage::component_type>(data_accessor.componentType);
         ds.d_type = static_cast<data_storage::type>(data_accessor.type);
 
         const auto type_size = tinygltf::GetComponentSizeInBytes(data_accessor.componentType);
         const auto type_components = tinygltf::GetNumComponentsInType(data_accessor.type);
         const auto element_size = type_size * type_components;
-        const auto stride = data_accessor.ByteStride(data_b_view);
 
         ds.normalized = data_accessor.normalized;
 
-        ds.data.resize(data_accessor.count * element_size);
+        // accessor without buffer view is initialized with zeros, sparse accessors may omit it.
+        ds.data.assign(data_accessor.count * element_size, 0);
 
-        auto dst_data_ptr = ds.data.data();
-        auto src_data_ptr = data_ptr;
+        if (data_accessor.bufferView >= 0) {
+            auto [acc, data_b_view, data_buf, data_ptr, data_size] = get_buffer_data(mdl, accessor_idx);
+            const auto stride = data_accessor.ByteStride(data_b_view);
 
-        for (size_t i = 0; i < data_accessor.count; ++i) {
-            std::memcpy(dst_data_ptr, src_data_ptr + data_accessor.byteOffset, element_size);
-            src_data_ptr += stride;
-            dst_data_ptr += element_size;
+            auto dst_data_ptr = ds.data.data();
+            auto src_data_ptr = data_ptr;
+
+            for (size_t i = 0; i < data_accessor.count; ++i) {
+                std::memcpy(dst_data_ptr, src_data_ptr + data_accessor.byteOffset, element_size);
+                src_data_ptr += stride;
+                dst_data_ptr += element_size;
+            }
+        }
+
+        if (data_accessor.sparse.isSparse) {
+            copy_sparse_bytes(ds, mdl, data_accessor, element_size);
         }
     }
 }
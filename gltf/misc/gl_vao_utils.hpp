@@ -1,6 +1,7 @@
 
 #pragma once
 
+#include <gl/buffer_arena.hpp>
 #include <gl/vertex_array_object.hpp>
 #include <gltf/misc/data_storage.hpp>
 #include <gltf/misc/element_utils.hpp>
@@ -28,5 +29,32 @@ namespace gltf::utils
 
         vao.add_vertex_array(buf, el_count, stride, 0, GLenum(ds.c_type), ds.normalized, loc);
     }
+
+    inline gl::buffer_arena<GL_ARRAY_BUFFER>::region fill_vao(
+        const gltf::data_storage& ds, gl::vertex_array_object& vao, int32_t loc, gl::buffer_arena<GL_ARRAY_BUFFER>& arena)
+    {
+        const auto region = arena.allocate(ds.data.data(), ds.data.size());
+
+        const auto el_size = get_element_size(ds.c_type);
+        const auto el_count = get_elements_count(ds.d_type);
+        const auto stride = el_size * el_count;
+
+        vao.add_vertex_array(arena.get_buffer(region), el_count, stride, region.offset, GLenum(ds.c_type), ds.normalized, loc);
+
+        return region;
+    }
+
+    inline gl::buffer_arena<GL_ELEMENT_ARRAY_BUFFER>::region fill_ebo(
+        const void* data, uint32_t size, gl::vertex_array_object& vao, gl::buffer_arena<GL_ELEMENT_ARRAY_BUFFER>& arena)
+    {
+        const auto region = arena.allocate(data, size, 4);
+
+        vao.bind();
+        arena.get_buffer(region).bind();
+        vao.unbind();
+        arena.get_buffer(region).unbind();
+
+        return region;
+    }
 }
 
@@ -0,0 +1,153 @@
+
+
+#include "morphing.hpp"
+
+#include <gltf/misc/vertex_utils.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    template<typename VecType>
+    void copy_base(const gltf::data_storage& ds, std::vector<VecType>& dst)
+    {
+        const auto vertices_count = gltf::utils::get_vertices_count(ds);
+        dst.resize(vertices_count);
+
+        if (vertices_count == 0) {
+            return;
+        }
+
+        const auto components_count = gltf::utils::get_elements_count(ds.d_type);
+
+        if (ds.c_type == gltf::data_storage::component_type::f32 && components_count == uint32_t(VecType::length())) {
+            std::memcpy(&dst.front(), ds.data.data(), ds.data.size());
+            return;
+        }
+
+        for (size_t v = 0; v < vertices_count; ++v) {
+            for (size_t c = 0; c < std::min<size_t>(components_count, VecType::length()); ++c) {
+                dst[v][c] = gltf::utils::read_component(ds, v * components_count + c);
+            }
+        }
+    }
+
+
+    template<typename VecType>
+    void restore(const std::vector<uint32_t>& vertices, const std::vector<VecType>& base, std::vector<VecType>& dst)
+    {
+        if (dst.empty()) {
+            return;
+        }
+
+        for (const auto v : vertices) {
+            dst[v] = base[v];
+        }
+    }
+
+
+    template<typename VecType>
+    void add_deltas(const std::vector<uint32_t>& vertices, const std::vector<glm::vec3>& deltas, float weight, std::vector<VecType>& dst)
+    {
+        if (deltas.empty() || dst.empty()) {
+            return;
+        }
+
+        for (size_t i = 0; i < vertices.size(); ++i) {
+            auto& v = dst[vertices[i]];
+            v.x += weight * deltas[i].x;
+            v.y += weight * deltas[i].y;
+            v.z += weight * deltas[i].z;
+        }
+    }
+} // namespace
+
+
+gltf::utils::morphing_stats gltf::utils::morph_vertices(
+    const gltf::mesh::geom_subset& subset,
+    const std::vector<float>& weights,
+    gltf::utils::morphed_vertices& dst,
+    float min_weight)
+{
+    if (dst.base_positions.size() != get_vertices_count(subset.positions) || dst.positions.size() != dst.base_positions.size()) {
+        copy_base(subset.positions, dst.base_positions);
+        copy_base(subset.normals, dst.base_normals);
+        copy_base(subset.tangents, dst.base_tangents);
+        dst.positions = dst.base_positions;
+        dst.normals = dst.base_normals;
+        dst.tangents = dst.base_tangents;
+        dst.weights.clear();
+    }
+
+    const auto targets_count = subset.morph_targets.size();
+    dst.weights.resize(targets_count, 0.f);
+
+    const auto get_weight = [&weights](size_t t) {
+        return t < weights.size() ? weights[t] : 0.f;
+    };
+
+    morphing_stats stats{};
+    bool changed = false;
+
+    for (size_t t = 0; t < targets_count; ++t) {
+        if (get_weight(t) != 0.f) {
+            stats.active_targets++;
+        }
+
+        changed = changed || std::abs(get_weight(t) - dst.weights[t]) > min_weight;
+    }
+
+    if (!changed) {
+        return stats;
+    }
+
+    stats.blended = true;
+
+    // every vertex outside of the active targets equals the base, so restoring them is a full reset.
+    for (size_t t = 0; t < targets_count; ++t) {
+        if (dst.weights[t] != 0.f) {
+            const auto& target = subset.morph_targets[t];
+            restore(target.vertices, dst.base_positions, dst.positions);
+            restore(target.vertices, dst.base_normals, dst.normals);
+            restore(target.vertices, dst.base_tangents, dst.tangents);
+        }
+    }
+
+    for (size_t t = 0; t < targets_count; ++t) {
+        const float weight = get_weight(t);
+        dst.weights[t] = weight;
+
+        if (weight == 0.f) {
+            continue;
+        }
+
+        const auto& target = subset.morph_targets[t];
+
+        add_deltas(target.vertices, target.positions, weight, dst.positions);
+        add_deltas(target.vertices, target.normals, weight, dst.normals);
+        add_deltas(target.vertices, target.tangents, weight, dst.tangents);
+
+        stats.applied_deltas += target.vertices.size();
+    }
+
+    return stats;
+}
+
+
+bool gltf::utils::sample_morph_weights(const gltf::animation& animation, uint32_t node, float time, std::vector<float>& weights)
+{
+    for (const auto& channel : animation.get_channels()) {
+        if (channel.node != node || channel.target != animation::channel::path::weights) {
+            continue;
+        }
+
+        weights.resize(channel.components);
+        animation::sample(channel, time, weights.data());
+
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,53 @@
+
+
+
+#pragma once
+
+#include <gltf/animation.hpp>
+#include <gltf/mesh.hpp>
+
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <vector>
+
+namespace gltf::utils
+{
+    struct morphed_vertices
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec4> tangents;
+        // weights the attributes are currently morphed with.
+        std::vector<float> weights;
+        // unmorphed attributes, vertices of the targets are restored from them before every blend.
+        std::vector<glm::vec3> base_positions;
+        std::vector<glm::vec3> base_normals;
+        std::vector<glm::vec4> base_tangents;
+    };
+
+    struct morphing_stats
+    {
+        uint32_t active_targets;
+        // deltas applied by the call.
+        size_t applied_deltas;
+        // dst was blended again, false if no weight changed enough.
+        bool blended;
+    };
+
+    // morphs dst to base attributes of the subset plus weighted deltas of the active targets.
+    // nothing is done unless a weight changed by more than min_weight since the previous call, otherwise
+    // vertices of the previously active targets are restored from the base and the active ones are blended
+    // again, so the cost is proportional to their deltas, not to vertices * targets, and no error accumulates.
+    // the base is copied on the first call or after dst is cleared.
+    // normals and tangents are not renormalized, shaders normalize them anyway.
+    morphing_stats morph_vertices(
+        const gltf::mesh::geom_subset& subset,
+        const std::vector<float>& weights,
+        morphed_vertices& dst,
+        float min_weight = 1e-4f);
+
+    // writes weights channel of the node at time into weights,
+    // returns false and keeps weights untouched when the animation does not drive the node.
+    bool sample_morph_weights(const gltf::animation& animation, uint32_t node, float time, std::vector<float>& weights);
+} // namespace gltf::utils
@@ -0,0 +1,370 @@
+
+
+#include "skinning.hpp"
+
+#include <gltf/misc/vertex_utils.hpp>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define GL_SANDBOX_SKINNING_SSE
+#endif
+
+namespace
+{
+    struct skinning_source
+    {
+        const float* positions;
+        const float* normals;
+        const float* tangents;
+        const uint8_t* joints;
+        const uint8_t* weights;
+        const float* palette;
+        uint32_t palette_size;
+    };
+
+
+    struct skinning_target
+    {
+        float* positions;
+        float* normals;
+        float* tangents;
+    };
+
+
+    template<typename JointType>
+    inline void read_joints(const uint8_t* src, size_t vertex, uint32_t* dst)
+    {
+        JointType joints[4];
+        std::memcpy(joints, src + vertex * sizeof(joints), sizeof(joints));
+
+        for (size_t i = 0; i < 4; ++i) {
+            dst[i] = joints[i];
+        }
+    }
+
+
+    template<typename WeightType>
+    inline void read_weights(const uint8_t* src, size_t vertex, float* dst)
+    {
+        WeightType weights[4];
+        std::memcpy(weights, src + vertex * sizeof(weights), sizeof(weights));
+
+        for (size_t i = 0; i < 4; ++i) {
+            if constexpr (std::is_floating_point_v<WeightType>) {
+                dst[i] = weights[i];
+            } else {
+                dst[i] = float(weights[i]) / float(std::numeric_limits<WeightType>::max());
+            }
+        }
+    }
+
+
+    inline void normalize3(float* v)
+    {
+        const float length = std::sqrt(v[0] * v[0] + v[1] * v[1] + v[2] * v[2]);
+
+        if (length > 0) {
+            const float inv_length = 1.f / length;
+            v[0] *= inv_length;
+            v[1] *= inv_length;
+            v[2] *= inv_length;
+        }
+    }
+
+
+#if defined(__AVX2__)
+    // blended matrix as two halves, columns 0-1 and 2-3.
+    struct blended_matrix
+    {
+        __m256 c01;
+        __m256 c23;
+    };
+
+
+    inline blended_matrix blend(const float* palette, const uint32_t* joints, const float* weights)
+    {
+        blended_matrix m{_mm256_setzero_ps(), _mm256_setzero_ps()};
+
+        for (size_t i = 0; i < 4; ++i) {
+            if (weights[i] == 0.f) {
+                continue;
+            }
+
+            const float* matrix = palette + joints[i] * 16;
+            const __m256 w = _mm256_set1_ps(weights[i]);
+            m.c01 = _mm256_fmadd_ps(w, _mm256_loadu_ps(matrix), m.c01);
+            m.c23 = _mm256_fmadd_ps(w, _mm256_loadu_ps(matrix + 8), m.c23);
+        }
+
+        return m;
+    }
+
+
+    inline void transform(const blended_matrix& m, const float* v, float w, float* dst)
+    {
+        // v.x * c0 + v.y * c1 in one register, v.z * c2 + w * c3 in the other.
+        const __m256 xy = _mm256_setr_ps(v[0], v[0], v[0], v[0], v[1], v[1], v[1], v[1]);
+        const __m256 zw = _mm256_setr_ps(v[2], v[2], v[2], v[2], w, w, w, w);
+        const __m256 sum = _mm256_add_ps(_mm256_mul_ps(m.c01, xy), _mm256_mul_ps(m.c23, zw));
+        const __m128 res = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+
+        alignas(16) float out[4];
+        _mm_store_ps(out, res);
+        dst[0] = out[0];
+        dst[1] = out[1];
+        dst[2] = out[2];
+    }
+#elif defined(GL_SANDBOX_SKINNING_SSE)
+    struct blended_matrix
+    {
+        __m128 c[4];
+    };
+
+
+    inline blended_matrix blend(const float* palette, const uint32_t* joints, const float* weights)
+    {
+        blended_matrix m{{_mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps(), _mm_setzero_ps()}};
+
+        for (size_t i = 0; i < 4; ++i) {
+            if (weights[i] == 0.f) {
+                continue;
+            }
+
+            const float* matrix = palette + joints[i] * 16;
+            const __m128 w = _mm_set1_ps(weights[i]);
+
+            for (size_t c = 0; c < 4; ++c) {
+                m.c[c] = _mm_add_ps(m.c[c], _mm_mul_ps(w, _mm_loadu_ps(matrix + c * 4)));
+            }
+        }
+
+        return m;
+    }
+
+
+    inline void transform(const blended_matrix& m, const float* v, float w, float* dst)
+    {
+        __m128 res = _mm_mul_ps(m.c[0], _mm_set1_ps(v[0]));
+        res = _mm_add_ps(res, _mm_mul_ps(m.c[1], _mm_set1_ps(v[1])));
+        res = _mm_add_ps(res, _mm_mul_ps(m.c[2], _mm_set1_ps(v[2])));
+        res = _mm_add_ps(res, _mm_mul_ps(m.c[3], _mm_set1_ps(w)));
+
+        alignas(16) float out[4];
+        _mm_store_ps(out, res);
+        dst[0] = out[0];
+        dst[1] = out[1];
+        dst[2] = out[2];
+    }
+#else
+    struct blended_matrix
+    {
+        float m[16];
+    };
+
+
+    inline blended_matrix blend(const float* palette, const uint32_t* joints, const float* weights)
+    {
+        blended_matrix m{};
+
+        for (size_t i = 0; i < 4; ++i) {
+            if (weights[i] == 0.f) {
+                continue;
+            }
+
+            const float* matrix = palette + joints[i] * 16;
+
+            for (size_t e = 0; e < 16; ++e) {
+                m.m[e] += weights[i] * matrix[e];
+            }
+        }
+
+        return m;
+    }
+
+
+    inline void transform(const blended_matrix& m, const float* v, float w, float* dst)
+    {
+        for (size_t r = 0; r < 3; ++r) {
+            dst[r] = m.m[r] * v[0] + m.m[4 + r] * v[1] + m.m[8 + r] * v[2] + m.m[12 + r] * w;
+        }
+    }
+#endif
+
+
+    template<typename JointType, typename WeightType>
+    void skin_range(const skinning_source& src, const skinning_target& dst, size_t first, size_t last)
+    {
+        for (size_t v = first; v < last; ++v) {
+            uint32_t joints[4];
+            float weights[4];
+            read_joints<JointType>(src.joints, v, joints);
+            read_weights<WeightType>(src.weights, v, weights);
+
+            for (size_t i = 0; i < 4; ++i) {
+                if (joints[i] >= src.palette_size) {
+                    joints[i] = 0;
+                    weights[i] = 0;
+                }
+            }
+
+            const auto m = blend(src.palette, joints, weights);
+
+            transform(m, src.positions + v * 3, 1.f, dst.positions + v * 3);
+
+            if (src.normals != nullptr) {
+                float* normal = dst.normals + v * 3;
+                transform(m, src.normals + v * 3, 0.f, normal);
+                normalize3(normal);
+            }
+
+            if (src.tangents != nullptr) {
+                float* tangent = dst.tangents + v * 4;
+                transform(m, src.tangents + v * 4, 0.f, tangent);
+                normalize3(tangent);
+                tangent[3] = src.tangents[v * 4 + 3];
+            }
+        }
+    }
+
+
+    using skin_range_func = void (*)(const skinning_source&, const skinning_target&, size_t, size_t);
+
+
+    template<typename JointType>
+    skin_range_func get_skin_range_func(gltf::data_storage::component_type weights_type)
+    {
+        switch (weights_type) {
+            case gltf::data_storage::component_type::f32:
+                return skin_range<JointType, float>;
+            case gltf::data_storage::component_type::u8:
+                return skin_range<JointType, uint8_t>;
+            case gltf::data_storage::component_type::u16:
+                return skin_range<JointType, uint16_t>;
+            default:
+                throw std::runtime_error("unsupported weights type.");
+        }
+    }
+
+
+    skin_range_func get_skin_range_func(gltf::data_storage::component_type joints_type, gltf::data_storage::component_type weights_type)
+    {
+        switch (joints_type) {
+            case gltf::data_storage::component_type::u8:
+                return get_skin_range_func<uint8_t>(weights_type);
+            case gltf::data_storage::component_type::u16:
+                return get_skin_range_func<uint16_t>(weights_type);
+            default:
+                throw std::runtime_error("unsupported joints type.");
+        }
+    }
+
+
+    const float* get_float_data(const gltf::data_storage& ds, gltf::data_storage::type expected_type)
+    {
+        if (ds.data.empty()) {
+            return nullptr;
+        }
+
+        if (ds.c_type != gltf::data_storage::component_type::f32 || ds.d_type != expected_type) {
+            throw std::runtime_error("unsupported skinned attribute type.");
+        }
+
+        return reinterpret_cast<const float*>(ds.data.data());
+    }
+} // namespace
+
+
+gltf::utils::skinning_stats gltf::utils::skin_vertices(
+    const gltf::mesh::geom_subset& subset,
+    const glm::mat4* palette,
+    size_t palette_size,
+    gltf::utils::skinned_vertices& dst,
+    ::utils::worker_pool* pool,
+    uint32_t range_size,
+    const gltf::utils::morphed_vertices* morphed,
+    int32_t skin_lod)
+{
+    const auto start = std::chrono::high_resolution_clock::now();
+
+    const auto vertices_count = get_vertices_count(subset.positions);
+    const auto& joints = skin_lod >= 0 ? subset.skin_lods.at(skin_lod).joints : subset.joints;
+    const auto& weights = skin_lod >= 0 ? subset.skin_lods.at(skin_lod).weights : subset.weights;
+
+    if (joints.data.empty() || weights.data.empty()) {
+        throw std::runtime_error("subset is not skinned.");
+    }
+
+    if (vertices_count == 0) {
+        dst.positions.clear();
+        dst.normals.clear();
+        dst.tangents.clear();
+        return skinning_stats{};
+    }
+
+    assert(get_vertices_count(joints) == vertices_count);
+    assert(get_vertices_count(weights) == vertices_count);
+
+    skinning_source src{};
+    src.positions = get_float_data(subset.positions, data_storage::type::vec3);
+    src.normals = get_float_data(subset.normals, data_storage::type::vec3);
+    src.tangents = get_float_data(subset.tangents, data_storage::type::vec4);
+    src.joints = joints.data.data();
+    src.weights = weights.data.data();
+    src.palette = reinterpret_cast<const float*>(palette);
+    src.palette_size = palette_size;
+
+    if (morphed != nullptr) {
+        assert(morphed->positions.size() == vertices_count);
+        src.positions = reinterpret_cast<const float*>(morphed->positions.data());
+        src.normals = src.normals != nullptr ? reinterpret_cast<const float*>(morphed->normals.data()) : nullptr;
+        src.tangents = src.tangents != nullptr ? reinterpret_cast<const float*>(morphed->tangents.data()) : nullptr;
+    }
+
+    dst.positions.resize(vertices_count);
+    dst.normals.resize(src.normals != nullptr ? vertices_count : 0);
+    dst.tangents.resize(src.tangents != nullptr ? vertices_count : 0);
+
+    skinning_target target{};
+    target.positions = reinterpret_cast<float*>(dst.positions.data());
+    target.normals = src.normals != nullptr ? reinterpret_cast<float*>(dst.normals.data()) : nullptr;
+    target.tangents = src.tangents != nullptr ? reinterpret_cast<float*>(dst.tangents.data()) : nullptr;
+
+    const auto skin_range_impl = get_skin_range_func(joints.c_type, weights.c_type);
+
+    range_size = std::max(range_size, 1u);
+    const uint32_t ranges_count = (vertices_count + range_size - 1) / range_size;
+
+    const auto run_range = [&](uint32_t range) {
+        const size_t first = size_t(range) * range_size;
+        const size_t last = std::min(first + range_size, vertices_count);
+        skin_range_impl(src, target, first, last);
+    };
+
+    if (pool != nullptr) {
+        pool->run(ranges_count, run_range);
+    } else {
+        for (uint32_t range = 0; range < ranges_count; ++range) {
+            run_range(range);
+        }
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::high_resolution_clock::now() - start;
+
+    skinning_stats stats{};
+    stats.vertices_count = vertices_count;
+    stats.seconds = elapsed.count();
+    stats.vertices_per_second = stats.seconds > 0 ? vertices_count / stats.seconds : 0;
+
+    return stats;
+}
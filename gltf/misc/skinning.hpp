@@ -0,0 +1,47 @@
+
+
+
+#pragma once
+
+#include <gltf/mesh.hpp>
+#include <gltf/misc/morphing.hpp>
+
+#include <worker_pool.hpp>
+
+#include <glm/mat4x4.hpp>
+#include <glm/vec3.hpp>
+#include <glm/vec4.hpp>
+
+#include <vector>
+
+namespace gltf::utils
+{
+    struct skinned_vertices
+    {
+        std::vector<glm::vec3> positions;
+        std::vector<glm::vec3> normals;
+        std::vector<glm::vec4> tangents;
+    };
+
+    struct skinning_stats
+    {
+        size_t vertices_count;
+        double seconds;
+        double vertices_per_second;
+    };
+
+    // linear blend skinning of the subset with the palette (world * inverse bind matrix per joint).
+    // JOINTS_0 may be u8 or u16, WEIGHTS_0 f32 or normalized u8/u16. normals and tangents are skinned when present.
+    // vertices are split into ranges of range_size and processed on the pool when it is given.
+    // morphed attributes are skinned instead of the subset ones when given.
+    // skin_lod selects JOINTS_0 and WEIGHTS_0 of a skin lod of the subset, the palette is indexed by lod joint then.
+    skinning_stats skin_vertices(
+        const gltf::mesh::geom_subset& subset,
+        const glm::mat4* palette,
+        size_t palette_size,
+        skinned_vertices& dst,
+        ::utils::worker_pool* pool = nullptr,
+        uint32_t range_size = 4096,
+        const morphed_vertices* morphed = nullptr,
+        int32_t skin_lod = -1);
+} // namespace gltf::utils
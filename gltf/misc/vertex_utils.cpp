@@ -0,0 +1,49 @@
+
+
+#include "vertex_utils.hpp"
+
+#include <glm/glm.hpp>
+
+#include <vector>
+
+
+std::vector<::utils::aabb> gltf::utils::get_vertices_bounds(const gltf::mesh::geom_subset& subset)
+{
+    const auto vertices_count = get_vertices_count(subset.positions);
+    const auto components_count = get_elements_count(subset.positions.d_type);
+
+    std::vector<::utils::aabb> vertices_bounds(vertices_count);
+
+    for (size_t v = 0; v < vertices_count; ++v) {
+        glm::vec3 position;
+
+        for (size_t c = 0; c < 3; ++c) {
+            position[c] = read_component(subset.positions, v * components_count + c);
+        }
+
+        vertices_bounds[v].expand(position);
+    }
+
+    // weights are in [0, 1], so a vertex moves by at most the sum of its deltas of every sign.
+    for (const auto& target : subset.morph_targets) {
+        for (size_t i = 0; i < target.vertices.size(); ++i) {
+            auto& box = vertices_bounds[target.vertices[i]];
+            box.min += glm::min(target.positions[i], glm::vec3{0});
+            box.max += glm::max(target.positions[i], glm::vec3{0});
+        }
+    }
+
+    return vertices_bounds;
+}
+
+
+::utils::aabb gltf::utils::get_bounds(const gltf::mesh::geom_subset& subset)
+{
+    ::utils::aabb bounds;
+
+    for (const auto& box : get_vertices_bounds(subset)) {
+        bounds.expand(box);
+    }
+
+    return bounds;
+}
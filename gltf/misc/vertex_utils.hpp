@@ -0,0 +1,116 @@
+
+
+
+#pragma once
+
+#include <gltf/mesh.hpp>
+#include <gltf/misc/data_storage.hpp>
+#include <gltf/misc/element_utils.hpp>
+
+#include <bounds.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace gltf::utils
+{
+    inline size_t get_vertices_count(const gltf::data_storage& ds)
+    {
+        if (ds.data.empty()) {
+            return 0;
+        }
+
+        return ds.data.size() / (get_element_size(ds.c_type) * get_elements_count(ds.d_type));
+    }
+
+
+    inline float read_component(const gltf::data_storage& ds, size_t index)
+    {
+        const auto ptr = ds.data.data() + index * get_element_size(ds.c_type);
+
+        switch (ds.c_type) {
+            case gltf::data_storage::component_type::f32:
+            {
+                float v;
+                std::memcpy(&v, ptr, sizeof(v));
+                return v;
+            }
+            case gltf::data_storage::component_type::u8:
+                return ds.normalized ? *ptr / 255.f : *ptr;
+            case gltf::data_storage::component_type::i8:
+                return ds.normalized ? std::max(int8_t(*ptr) / 127.f, -1.f) : int8_t(*ptr);
+            case gltf::data_storage::component_type::u16:
+            {
+                uint16_t v;
+                std::memcpy(&v, ptr, sizeof(v));
+                return ds.normalized ? v / 65535.f : v;
+            }
+            case gltf::data_storage::component_type::i16:
+            {
+                int16_t v;
+                std::memcpy(&v, ptr, sizeof(v));
+                return ds.normalized ? std::max(v / 32767.f, -1.f) : v;
+            }
+            case gltf::data_storage::component_type::u32:
+            {
+                uint32_t v;
+                std::memcpy(&v, ptr, sizeof(v));
+                return v;
+            }
+            default:
+                throw std::runtime_error("unsupported component type");
+        }
+    }
+
+
+    inline uint32_t read_index(const gltf::data_storage& ds, size_t index)
+    {
+        const auto ptr = ds.data.data() + index * get_element_size(ds.c_type);
+
+        switch (ds.c_type) {
+            case gltf::data_storage::component_type::u8:
+                return *ptr;
+            case gltf::data_storage::component_type::u16:
+            {
+                uint16_t v;
+                std::memcpy(&v, ptr, sizeof(v));
+                return v;
+            }
+            case gltf::data_storage::component_type::u32:
+            {
+                uint32_t v;
+                std::memcpy(&v, ptr, sizeof(v));
+                return v;
+            }
+            default:
+                throw std::runtime_error("unsupported index type");
+        }
+    }
+
+
+    // reads JOINTS_0 and WEIGHTS_0 of the vertex, weights are decoded from any normalized type.
+    inline void read_influences(const gltf::data_storage& joints, const gltf::data_storage& weights, size_t vertex, uint32_t* dst_joints, float* dst_weights)
+    {
+        for (size_t i = 0; i < 4; ++i) {
+            dst_joints[i] = read_index(joints, vertex * 4 + i);
+            dst_weights[i] = read_component(weights, vertex * 4 + i);
+        }
+    }
+
+
+    // indexed subsets share vertex pools, except the ones whose vertices are rewritten on the cpu every frame,
+    // morphed and cpu skinned subsets keep vertex regions of their own.
+    inline bool is_pooled(const gltf::mesh::geom_subset& subset, bool cpu_skinning)
+    {
+        const bool skinned = !subset.joints.data.empty() && !subset.weights.data.empty();
+        return !subset.indices.data.empty() && subset.morph_targets.empty() && !(cpu_skinning && skinned);
+    }
+
+
+    // bounds of every vertex position, grown by its morph targets deltas so that any blend of them stays inside.
+    std::vector<::utils::aabb> get_vertices_bounds(const gltf::mesh::geom_subset& subset);
+
+    // mesh space bounds of the vertices bounds.
+    ::utils::aabb get_bounds(const gltf::mesh::geom_subset& subset);
+} // namespace gltf::utils
@@ -0,0 +1,73 @@
+
+
+#include "pbr_features.hpp"
+
+#include <gltf/misc/vertex_utils.hpp>
+
+#include <shaders.hpp>
+
+#include <third/tinygltf/tiny_gltf.h>
+
+#include <utility>
+
+namespace
+{
+    constexpr std::pair<gltf::pbr_feature, const char*> feature_defines[]{
+        {gltf::skinning, "ANIM"},
+        {gltf::normal_map, "NORMAL_MAP"},
+        {gltf::emissive, "EMISSIVE"},
+        {gltf::occlusion, "OCCLUSION"},
+        {gltf::ibl, "IBL"},
+        {gltf::vertex_colors, "VERTEX_COLORS"},
+        {gltf::multi_draw, "MULTI_DRAW"}};
+} // namespace
+
+
+uint32_t gltf::get_pbr_features(const tinygltf::Model& model, const gltf::mesh::geom_subset& subset, bool skinning)
+{
+    const auto& mat = model.materials.at(subset.material);
+
+    // the environment is bound to every material by gl_scene_builder.
+    uint32_t features = ibl;
+
+    if (skinning && !subset.joints.data.empty() && !subset.weights.data.empty()) {
+        features |= gltf::skinning;
+    }
+
+    if (mat.normalTexture.index >= 0 && !subset.tangents.data.empty()) {
+        features |= normal_map;
+    }
+
+    if (mat.emissiveTexture.index >= 0) {
+        features |= emissive;
+    }
+
+    if (mat.occlusionTexture.index >= 0) {
+        features |= occlusion;
+    }
+
+    if (!subset.vertices_colors.data.empty()) {
+        features |= vertex_colors;
+    }
+
+    // pooled subsets, see common_mesh_builder.
+    if (utils::is_pooled(subset, !skinning)) {
+        features |= multi_draw;
+    }
+
+    return features;
+}
+
+
+gl::program_sources gltf::make_pbr_sources(uint32_t features)
+{
+    std::vector<std::string> defines;
+
+    for (const auto& [feature, define] : feature_defines) {
+        if (features & feature) {
+            defines.emplace_back(define);
+        }
+    }
+
+    return {gl::add_defines(shaders::pbr_vss, defines), gl::add_defines(shaders::pbr_fss, defines)};
+}
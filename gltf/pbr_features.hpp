@@ -0,0 +1,40 @@
+
+
+#pragma once
+
+#include <gltf/mesh.hpp>
+
+#include <gl/program_cache.hpp>
+
+#include <cinttypes>
+
+namespace tinygltf
+{
+    class Model;
+}
+
+namespace gltf
+{
+    // parts of the pbr shaders a material pays for only if it needs them, every bit is a #define.
+    enum pbr_feature : uint32_t
+    {
+        skinning = 1 << 0,
+        normal_map = 1 << 1,
+        emissive = 1 << 2,
+        occlusion = 1 << 3,
+        ibl = 1 << 4,
+        vertex_colors = 1 << 5,
+        // draw data fetched by vertex pool slot, see gl::scene::vertex_pool.
+        multi_draw = 1 << 6
+    };
+
+    // features a fallback variant keeps, the ones the vertex layout and draw data depend on, and lighting.
+    constexpr uint32_t pbr_fallback_features = skinning | multi_draw | ibl;
+
+    // features of what the subset and its material contain.
+    // morph targets are blended on the cpu (see utils::morph_vertices), so they need no variant.
+    // without skinning the subset is skinned on the cpu and drawn as a static mesh.
+    uint32_t get_pbr_features(const tinygltf::Model& model, const mesh::geom_subset& subset, bool skinning = true);
+
+    gl::program_sources make_pbr_sources(uint32_t features);
+} // namespace gltf
@@ -0,0 +1,481 @@
+
+
+#include "pose_evaluator.hpp"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+
+gltf::pose_evaluator::pose_evaluator(
+    const std::vector<skin>& skins,
+    const std::vector<animation>& animations,
+    utils::worker_pool& pool,
+    uint32_t batch_size)
+    : m_skins(skins)
+    , m_animations(animations)
+    , m_pool(pool)
+    , m_batch_size(std::max(batch_size, 1u))
+{
+    for (const auto& skin : m_skins) {
+        m_palette_stride = std::max(m_palette_stride, uint32_t(skin.get_joints().size()));
+    }
+}
+
+
+uint32_t gltf::pose_evaluator::add_instance(uint32_t skin, int32_t animation)
+{
+    assert(skin < m_skins.size());
+    check_palette_texture_size(m_instances.size() + 1);
+
+    auto& curr_instance = m_instances.emplace_back();
+    curr_instance.skin = skin;
+    curr_instance.animation = animation;
+
+    m_instances_bindings.emplace_back(get_bindings(skin, animation));
+
+    // phases are staggered, so instances with the same update interval do not all land on the same frame.
+    auto& lod = m_instances_lods.emplace_back();
+    lod.phase = m_instances.size() - 1;
+
+    m_palette.resize(m_instances.size() * m_palette_stride, glm::mat4{1});
+    m_prev_palette.resize(m_palette.size(), glm::mat4{1});
+    m_next_palette.resize(m_palette.size(), glm::mat4{1});
+
+    return m_instances.size() - 1;
+}
+
+
+void gltf::pose_evaluator::set_animation(uint32_t instance, int32_t animation)
+{
+    auto& curr_instance = m_instances.at(instance);
+    curr_instance.animation = animation;
+    curr_instance.time = 0;
+    m_instances_bindings.at(instance) = get_bindings(curr_instance.skin, animation);
+    m_instances_lods.at(instance).frames_since_update = 0;
+}
+
+
+void gltf::pose_evaluator::set_skeleton_lod(uint32_t instance, int32_t lod)
+{
+    auto& curr_instance = m_instances.at(instance);
+    assert(lod < int32_t(m_skins.at(curr_instance.skin).lods.size()));
+    curr_instance.skeleton_lod = lod;
+    m_instances_lods.at(instance).frames_since_update = 0;
+    m_instances_lods.at(instance).layout_changed = true;
+}
+
+
+gltf::pose_evaluator::instance& gltf::pose_evaluator::get_instance(uint32_t i)
+{
+    return m_instances.at(i);
+}
+
+
+const gltf::pose_evaluator::instance& gltf::pose_evaluator::get_instance(uint32_t i) const
+{
+    return m_instances.at(i);
+}
+
+
+uint32_t gltf::pose_evaluator::get_instances_count() const
+{
+    return m_instances.size();
+}
+
+
+void gltf::pose_evaluator::set_lod_policy(const gltf::pose_evaluator::lod_policy& policy)
+{
+    m_lod_policy = policy;
+}
+
+
+const gltf::pose_evaluator::lod_policy& gltf::pose_evaluator::get_lod_policy() const
+{
+    return m_lod_policy;
+}
+
+
+uint32_t gltf::pose_evaluator::get_update_interval(float screen_size) const
+{
+    if (screen_size >= m_lod_policy.full_rate_size) {
+        return 1;
+    }
+
+    if (screen_size >= m_lod_policy.half_rate_size) {
+        return 2;
+    }
+
+    return 4;
+}
+
+
+void gltf::pose_evaluator::update(float dt)
+{
+    for (auto& curr_instance : m_instances) {
+        curr_instance.time = get_animation_time(curr_instance, curr_instance.time + dt * curr_instance.speed);
+    }
+
+    m_evaluated_instances = 0;
+
+    const uint32_t instances_count = m_instances.size();
+    const uint32_t jobs_count = (instances_count + m_batch_size - 1) / m_batch_size;
+
+    m_pool.run(jobs_count, [this, instances_count, dt](uint32_t job) {
+        const auto first = job * m_batch_size;
+        const auto last = std::min(first + m_batch_size, instances_count);
+
+        for (auto i = first; i < last; ++i) {
+            update_instance(i, dt);
+        }
+    });
+
+    ++m_frame;
+}
+
+
+uint32_t gltf::pose_evaluator::get_evaluated_instances_count() const
+{
+    return m_evaluated_instances;
+}
+
+
+float gltf::pose_evaluator::get_screen_size(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& center, float radius)
+{
+    const auto view_center = view * glm::vec4{center, 1.f};
+    const auto depth = -view_center.z;
+
+    if (depth <= radius) {
+        return 1;
+    }
+
+    // projection[1][1] is cot(fov / 2), so radius * cot / depth is the radius in half viewport heights.
+    return std::min(radius * projection[1][1] / depth, 1.f);
+}
+
+
+const std::vector<glm::mat4>& gltf::pose_evaluator::get_palette() const
+{
+    return m_palette;
+}
+
+
+uint32_t gltf::pose_evaluator::get_palette_stride() const
+{
+    return m_palette_stride;
+}
+
+
+uint32_t gltf::pose_evaluator::make_palette_texture(gl::scene::scene& gl_scene)
+{
+    if (m_palette_texture < 0) {
+        int32_t max_texture_size;
+        glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_texture_size);
+        m_max_texture_size = max_texture_size;
+        check_palette_texture_size(m_instances.size());
+
+        gl_scene.textures.emplace_back(gl::texture<GL_TEXTURE_2D>{GL_NEAREST});
+        m_palette_texture = gl_scene.textures.size() - 1;
+        m_palette_texture_rows = 0;
+    }
+
+    return m_palette_texture;
+}
+
+
+void gltf::pose_evaluator::upload_palette(gl::scene::scene& gl_scene)
+{
+    if (m_palette_texture < 0 || m_instances.empty() || m_palette_stride == 0) {
+        return;
+    }
+
+    const auto& tex = std::get<gl::texture<GL_TEXTURE_2D>>(gl_scene.textures.at(m_palette_texture));
+    const int32_t width = m_palette_stride * 4;
+    const int32_t rows = m_instances.size();
+    const float* palette_data = glm::value_ptr(m_palette.front());
+
+    // storage is reallocated only when instances were added, otherwise the whole palette is one sub image upload.
+    if (uint32_t(rows) > m_palette_texture_rows) {
+        tex.fill(const_cast<float*>(palette_data), width, rows, 4, false);
+        m_palette_texture_rows = rows;
+    } else {
+        tex.update(palette_data, width, rows);
+    }
+}
+
+
+void gltf::pose_evaluator::bind_instance(gl::scene::scene& gl_scene, gl::scene::material& material, uint32_t instance) const
+{
+    assert(m_palette_texture >= 0);
+    assert(instance < m_instances.size());
+
+    material.add_texture("s_anim", m_palette_texture);
+
+    if (const auto anim_key = material.find_parameter(gl::scene::intern("u_ANIM_KEY")); anim_key >= 0) {
+        assert(gl_scene.parameters.at(anim_key).get_param_type() == gl::scene::parameter_type::i32);
+        gl_scene.parameters.set(anim_key, int32_t(instance));
+    }
+}
+
+
+const std::vector<gltf::pose_evaluator::channel_binding>* gltf::pose_evaluator::get_bindings(uint32_t skin, int32_t animation)
+{
+    if (animation < 0) {
+        return nullptr;
+    }
+
+    auto [bindings_it, inserted] = m_bindings.try_emplace({skin, animation});
+
+    if (inserted) {
+        const auto& nodes = m_skins.at(skin).get_nodes();
+        const auto& ancestors = m_skins.at(skin).get_ancestors();
+        const auto& channels = m_animations.at(animation).get_channels();
+
+        for (uint32_t channel = 0; channel < channels.size(); ++channel) {
+            if (channels[channel].target == animation::channel::path::weights) {
+                continue;
+            }
+
+            const auto is_target = [&channels, channel](const std::shared_ptr<scene_graph::node>& node) {
+                return node != nullptr && node->get_node_index() == channels[channel].node;
+            };
+
+            if (const auto joint = std::find_if(nodes.begin(), nodes.end(), is_target); joint != nodes.end()) {
+                bindings_it->second.emplace_back(channel_binding{channel, uint32_t(joint - nodes.begin()), false});
+            } else if (const auto ancestor = std::find_if(ancestors.begin(), ancestors.end(), is_target); ancestor != ancestors.end()) {
+                bindings_it->second.emplace_back(channel_binding{channel, uint32_t(ancestor - ancestors.begin()), true});
+            }
+        }
+    }
+
+    return &bindings_it->second;
+}
+
+
+void gltf::pose_evaluator::update_instance(uint32_t instance, float dt)
+{
+    const auto& curr_instance = m_instances[instance];
+    auto& lod = m_instances_lods[instance];
+    const auto offset = instance * m_palette_stride;
+    const auto joints_count = get_palette_size(curr_instance);
+
+    const bool is_update_frame = lod.frames_since_update == 0 || lod.frames_since_update >= lod.interval || (m_frame + lod.phase) % lod.interval == 0;
+
+    if (is_update_frame) {
+        lod.interval = get_update_interval(curr_instance.screen_size);
+        lod.frames_since_update = 0;
+
+        if (lod.interval == 1) {
+            evaluate(instance, curr_instance.time, m_palette.data() + offset);
+            lod.frames_since_update = 1;
+            lod.layout_changed = false;
+            ++m_evaluated_instances;
+            return;
+        }
+
+        if (lod.layout_changed) {
+            evaluate(instance, curr_instance.time, m_palette.data() + offset);
+            lod.layout_changed = false;
+        }
+
+        // the pose is evaluated where the instance will be at its next update,
+        // the frames in between blend towards it from what is displayed now.
+        std::copy_n(m_palette.begin() + offset, joints_count, m_prev_palette.begin() + offset);
+        const auto target_time = curr_instance.time + dt * curr_instance.speed * (lod.interval - 1);
+        evaluate(instance, get_animation_time(curr_instance, target_time), m_next_palette.data() + offset);
+        ++m_evaluated_instances;
+    }
+
+    ++lod.frames_since_update;
+
+    const float factor = float(lod.frames_since_update) / float(lod.interval);
+    const float* prev = glm::value_ptr(m_prev_palette[offset]);
+    const float* next = glm::value_ptr(m_next_palette[offset]);
+    float* dst = glm::value_ptr(m_palette[offset]);
+
+    for (size_t i = 0; i < joints_count * 16; ++i) {
+        dst[i] = prev[i] + (next[i] - prev[i]) * factor;
+    }
+}
+
+
+float gltf::pose_evaluator::get_animation_time(const gltf::pose_evaluator::instance& instance, float time) const
+{
+    if (instance.animation < 0) {
+        return 0;
+    }
+
+    const auto duration = m_animations.at(instance.animation).get_duration();
+
+    if (duration <= 0) {
+        return 0;
+    }
+
+    if (instance.loop) {
+        time = std::fmod(time, duration);
+        return time < 0 ? time + duration : time;
+    }
+
+    return std::min(std::max(time, 0.f), duration);
+}
+
+
+::utils::aabb gltf::pose_evaluator::get_bounds(uint32_t instance, const glm::mat4& model) const
+{
+    const auto& curr_instance = m_instances.at(instance);
+    const auto& skin = m_skins[curr_instance.skin];
+    const auto* lod = curr_instance.skeleton_lod >= 0 ? &skin.lods.at(curr_instance.skeleton_lod) : nullptr;
+    const auto* palette = m_palette.data() + instance * m_palette_stride;
+
+    ::utils::aabb bounds;
+
+    for (uint32_t joint = 0; joint < skin.joints_bounds.size(); ++joint) {
+        const uint32_t palette_index = lod != nullptr ? lod->joints_map[joint] : joint;
+        bounds.expand(::utils::transform_aabb(palette[palette_index], skin.joints_bounds[joint]));
+    }
+
+    return ::utils::transform_aabb(model, bounds);
+}
+
+
+void gltf::pose_evaluator::check_palette_texture_size(uint32_t instances_count) const
+{
+    // every joint matrix takes four texels (one per column), every instance takes one row.
+    if (m_max_texture_size > 0 && (m_palette_stride * 4 > m_max_texture_size || instances_count > m_max_texture_size)) {
+        throw std::runtime_error("skin palettes do not fit into texture.");
+    }
+}
+
+
+uint32_t gltf::pose_evaluator::get_palette_size(const gltf::pose_evaluator::instance& instance) const
+{
+    const auto& skin = m_skins[instance.skin];
+
+    if (instance.skeleton_lod >= 0) {
+        return skin.lods.at(instance.skeleton_lod).joints.size();
+    }
+
+    return skin.get_joints().size();
+}
+
+
+void gltf::pose_evaluator::evaluate(uint32_t instance, float time, glm::mat4* palette)
+{
+    struct joint_pose
+    {
+        glm::vec3 translation;
+        glm::quat rotation;
+        glm::vec3 scale;
+    };
+
+    thread_local std::vector<joint_pose> poses;
+    thread_local std::vector<joint_pose> ancestor_poses;
+    thread_local std::vector<glm::mat4> world_matrices;
+    thread_local std::vector<glm::mat4> ancestor_matrices;
+    thread_local std::vector<bool> animated_ancestors;
+
+    const auto& curr_instance = m_instances[instance];
+    const auto& skin = m_skins[curr_instance.skin];
+    const auto& joints = skin.get_joints();
+    const auto& ancestors = skin.get_ancestors();
+    const auto& inv_bind_poses = skin.get_nodes_matrices();
+
+    // kept joints of a lod are closed under their parents, so collapsed joints are skipped entirely.
+    const auto lod = curr_instance.skeleton_lod >= 0 ? &skin.lods.at(curr_instance.skeleton_lod) : nullptr;
+    const auto is_collapsed = [lod](uint32_t joint) {
+        return lod != nullptr && lod->joints[lod->joints_map[joint]] != joint;
+    };
+
+    poses.resize(joints.size());
+    world_matrices.resize(joints.size());
+
+    for (size_t i = 0; i < joints.size(); ++i) {
+        poses[i] = {joints[i].translation, joints[i].rotation, joints[i].scale};
+    }
+
+    ancestor_poses.resize(ancestors.size());
+    animated_ancestors.assign(ancestors.size(), false);
+    bool has_animated_ancestors = false;
+
+    for (size_t i = 0; i < ancestors.size(); ++i) {
+        ancestor_poses[i] = {ancestors[i]->translation, ancestors[i]->rotation, ancestors[i]->scale};
+    }
+
+    if (const auto bindings = m_instances_bindings[instance]; bindings != nullptr) {
+        const auto& channels = m_animations[curr_instance.animation].get_channels();
+
+        for (const auto& binding : *bindings) {
+            if (!binding.ancestor && is_collapsed(binding.joint)) {
+                continue;
+            }
+
+            if (binding.ancestor) {
+                animated_ancestors[binding.joint] = true;
+                has_animated_ancestors = true;
+            }
+
+            const auto& channel = channels[binding.channel];
+            auto& pose = binding.ancestor ? ancestor_poses[binding.joint] : poses[binding.joint];
+            float value[4];
+
+            animation::sample(channel, time, value);
+
+            switch (channel.target) {
+                case animation::channel::path::translation:
+                    pose.translation = glm::vec3{value[0], value[1], value[2]};
+                    break;
+                case animation::channel::path::rotation:
+                    pose.rotation = glm::quat{value[3], value[0], value[1], value[2]};
+                    break;
+                case animation::channel::path::scale:
+                    pose.scale = glm::vec3{value[0], value[1], value[2]};
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+
+    const auto to_matrix = [](const joint_pose& pose) {
+        return glm::translate(glm::mat4{1}, pose.translation) * glm::mat4_cast(pose.rotation) * glm::scale(glm::mat4{1}, pose.scale);
+    };
+
+    // joints keep the rest transformation of the nodes above them until an animation moves one of these nodes,
+    // animated nodes have trs transformations, the others may have a matrix.
+    if (has_animated_ancestors) {
+        ancestor_matrices.resize(ancestors.size());
+
+        for (size_t i = 0; i < ancestors.size(); ++i) {
+            ancestor_matrices[i] = animated_ancestors[i] ? to_matrix(ancestor_poses[i]) : ancestors[i]->get_local_transformation();
+        }
+    }
+
+    for (const auto joint : skin.get_evaluation_order()) {
+        if (is_collapsed(joint)) {
+            continue;
+        }
+
+        const uint32_t palette_index = lod != nullptr ? lod->joints_map[joint] : joint;
+
+        const auto& pose = poses[joint];
+        const auto& joint_info = joints[joint];
+
+        const auto local = to_matrix(pose);
+        const auto parent = joint_info.parent >= 0 ? world_matrices[joint_info.parent] : glm::mat4{1};
+        auto parent_transform = joint_info.parent_transform;
+
+        if (has_animated_ancestors) {
+            parent_transform = glm::mat4{1};
+
+            for (const auto ancestor : joint_info.ancestors) {
+                parent_transform = ancestor_matrices[ancestor] * parent_transform;
+            }
+        }
+
+        world_matrices[joint] = parent * parent_transform * local;
+        palette[palette_index] = world_matrices[joint] * inv_bind_poses[joint];
+    }
+}
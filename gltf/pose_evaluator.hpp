@@ -0,0 +1,130 @@
+
+
+#pragma once
+
+#include <gltf/animation.hpp>
+#include <gltf/skin.hpp>
+
+#include <gl/scene/scene.hpp>
+
+#include <bounds.hpp>
+#include <worker_pool.hpp>
+
+#include <glm/mat4x4.hpp>
+
+#include <map>
+#include <vector>
+
+namespace gltf
+{
+    class pose_evaluator
+    {
+    public:
+        struct instance
+        {
+            uint32_t skin = 0;
+            int32_t animation = -1;
+            float time = 0;
+            float speed = 1;
+            bool loop = true;
+            // fraction of the viewport height covered by the instance, drives update rate.
+            float screen_size = 1;
+            // index into skin lods, -1 evaluates the full skeleton.
+            int32_t skeleton_lod = -1;
+        };
+
+        struct lod_policy
+        {
+            // instances at least this big are updated every frame.
+            float full_rate_size = 0.2f;
+            // instances at least this big are updated every 2nd frame, smaller ones every 4th.
+            float half_rate_size = 0.05f;
+        };
+
+        pose_evaluator(const std::vector<skin>& skins, const std::vector<animation>& animations, utils::worker_pool& pool, uint32_t batch_size = 8);
+        ~pose_evaluator() = default;
+
+        uint32_t add_instance(uint32_t skin, int32_t animation = -1);
+        void set_animation(uint32_t instance, int32_t animation);
+        // the palette layout of the instance changes, so it is evaluated again on the next update.
+        void set_skeleton_lod(uint32_t instance, int32_t lod);
+        instance& get_instance(uint32_t);
+        const instance& get_instance(uint32_t) const;
+        uint32_t get_instances_count() const;
+
+        void set_lod_policy(const lod_policy& policy);
+        const lod_policy& get_lod_policy() const;
+        uint32_t get_update_interval(float screen_size) const;
+
+        // advances instances time and evaluates palettes of the instances due this frame on the worker pool,
+        // palettes of the others are interpolated towards their last evaluated pose.
+        void update(float dt);
+        uint32_t get_evaluated_instances_count() const;
+
+        // world bounds of the current pose, union of the skin joints bounds transformed by the palette.
+        // costs O(joints) and is conservative for any blend of the joints.
+        ::utils::aabb get_bounds(uint32_t instance, const glm::mat4& model = glm::mat4{1}) const;
+
+        static float get_screen_size(const glm::mat4& view, const glm::mat4& projection, const glm::vec3& center, float radius);
+
+        // palette holds get_palette_stride() matrices per instance, instance i starts at i * stride.
+        // instances with a skeleton lod fill only the first lod joints count matrices, indexed by lod joint.
+        const std::vector<glm::mat4>& get_palette() const;
+        uint32_t get_palette_stride() const;
+
+        // palette texture has the s_anim layout, instance index is the u_ANIM_KEY row.
+        // throws if the palette of the widest skin or the instances do not fit into a texture.
+        uint32_t make_palette_texture(gl::scene::scene& gl_scene);
+        void upload_palette(gl::scene::scene& gl_scene);
+        void bind_instance(gl::scene::scene& gl_scene, gl::scene::material& material, uint32_t instance) const;
+
+    private:
+        struct channel_binding
+        {
+            uint32_t channel;
+            uint32_t joint;
+            // joint is an index into the skin ancestors then.
+            bool ancestor = false;
+        };
+
+        struct instance_lod
+        {
+            uint32_t interval = 1;
+            uint32_t phase = 0;
+            uint32_t frames_since_update = 0;
+            // the displayed palette has another layout, it is not blended from.
+            bool layout_changed = false;
+        };
+
+        const std::vector<channel_binding>* get_bindings(uint32_t skin, int32_t animation);
+        void update_instance(uint32_t instance, float dt);
+        void evaluate(uint32_t instance, float time, glm::mat4* dst);
+        float get_animation_time(const instance& instance, float time) const;
+        uint32_t get_palette_size(const instance& instance) const;
+        // no-op until the palette texture is made.
+        void check_palette_texture_size(uint32_t instances_count) const;
+
+        const std::vector<skin>& m_skins;
+        const std::vector<animation>& m_animations;
+        utils::worker_pool& m_pool;
+        uint32_t m_batch_size;
+        uint32_t m_palette_stride{0};
+
+        std::vector<instance> m_instances;
+        std::vector<instance_lod> m_instances_lods;
+        std::vector<const std::vector<channel_binding>*> m_instances_bindings;
+        std::map<std::pair<uint32_t, int32_t>, std::vector<channel_binding>> m_bindings;
+        std::vector<glm::mat4> m_palette;
+        std::vector<glm::mat4> m_prev_palette;
+        std::vector<glm::mat4> m_next_palette;
+
+        lod_policy m_lod_policy{};
+        uint64_t m_frame{0};
+        std::atomic_uint32_t m_evaluated_instances{0};
+
+        int32_t m_palette_texture{-1};
+        uint32_t m_palette_texture_rows{0};
+        // GL_MAX_TEXTURE_SIZE, queried with the palette texture.
+        uint32_t m_max_texture_size{0};
+    };
+} // namespace gltf
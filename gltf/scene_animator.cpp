@@ -0,0 +1,339 @@
+
+
+#include "scene_animator.hpp"
+
+#include <gl/profiler.hpp>
+
+#include <bounds.hpp>
+
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // first animation moving a joint of the skin or a node above them, -1 if none does.
+    int32_t find_animation(const gltf::skin& skin, const std::vector<gltf::animation>& animations)
+    {
+        for (uint32_t animation = 0; animation < animations.size(); ++animation) {
+            for (const auto& channel : animations[animation].get_channels()) {
+                if (channel.target == gltf::animation::channel::path::weights) {
+                    continue;
+                }
+
+                const auto is_target = [&channel](const std::shared_ptr<gltf::scene_graph::node>& node) {
+                    return node != nullptr && node->get_node_index() == channel.node;
+                };
+
+                if (std::any_of(skin.get_nodes().begin(), skin.get_nodes().end(), is_target)
+                    || std::any_of(skin.get_ancestors().begin(), skin.get_ancestors().end(), is_target)) {
+                    return animation;
+                }
+            }
+        }
+
+        return -1;
+    }
+
+
+    bool is_skinned(const gltf::mesh& mesh, const gltf::mesh::geom_subset& subset)
+    {
+        return mesh.get_skin_index() >= 0 && !subset.joints.data.empty() && !subset.weights.data.empty();
+    }
+
+
+    // first animation with a weights channel of the node, -1 if none has one.
+    int32_t find_morph_animation(uint32_t node, const std::vector<gltf::animation>& animations)
+    {
+        for (uint32_t animation = 0; animation < animations.size(); ++animation) {
+            for (const auto& channel : animations[animation].get_channels()) {
+                if (channel.target == gltf::animation::channel::path::weights && channel.node == node) {
+                    return animation;
+                }
+            }
+        }
+
+        return -1;
+    }
+
+
+    // animated attributes are written over the uploaded ones, so they have to be floats.
+    bool has_float_attributes(const gltf::mesh::geom_subset& subset)
+    {
+        const auto is_float = [](const gltf::data_storage& ds) {
+            return ds.data.empty() || ds.c_type == gltf::data_storage::component_type::f32;
+        };
+
+        return is_float(subset.positions) && is_float(subset.normals) && is_float(subset.tangents);
+    }
+
+
+    // vertex regions are allocated in location order of the attributes the subset has, see adj_mesh_builder.
+    int32_t get_region_index(const gltf::mesh::geom_subset& subset, const gltf::data_storage& attribute)
+    {
+        const gltf::data_storage* attributes[]{
+            &subset.positions,
+            &subset.tex_coords0,
+            &subset.normals,
+            &subset.tangents,
+            &subset.joints,
+            &subset.weights,
+            &subset.tex_coords1,
+            &subset.vertices_colors};
+
+        int32_t index = 0;
+
+        for (const auto* curr_attribute : attributes) {
+            if (curr_attribute == &attribute) {
+                return attribute.data.empty() ? -1 : index;
+            }
+
+            index += curr_attribute->data.empty() ? 0 : 1;
+        }
+
+        return -1;
+    }
+
+
+    template<typename VecType>
+    void upload_attribute(gl::scene::scene& gl_scene, const gl::scene::mesh& mesh, int32_t region_index, const std::vector<VecType>& data)
+    {
+        if (region_index < 0 || data.empty()) {
+            return;
+        }
+
+        const auto& region = mesh.get_vertex_regions().at(region_index);
+        assert(region.size == data.size() * sizeof(VecType));
+        gl_scene.vertex_arena.upload(region, data.data());
+    }
+
+
+    // skinned or morphed vertices.
+    template<typename VerticesType>
+    void upload_vertices(gl::scene::scene& gl_scene, const gltf::mesh::geom_subset& subset, uint32_t mesh, const VerticesType& vertices)
+    {
+        const auto& gl_mesh = gl_scene.meshes.at(mesh);
+        upload_attribute(gl_scene, gl_mesh, get_region_index(subset, subset.positions), vertices.positions);
+        upload_attribute(gl_scene, gl_mesh, get_region_index(subset, subset.normals), vertices.normals);
+        upload_attribute(gl_scene, gl_mesh, get_region_index(subset, subset.tangents), vertices.tangents);
+    }
+} // namespace
+
+
+gltf::scene_animator::scene_animator(
+    const gltf::meshes_processor& processor,
+    gl::scene::scene& gl_scene,
+    ::utils::worker_pool& pool,
+    bool cpu_skinning)
+    : m_scene(gl_scene)
+    , m_pool(pool)
+    , m_skins(processor.get_skins())
+    , m_animations(processor.get_animations())
+    , m_evaluator(processor.get_skins(), processor.get_animations(), pool)
+    , m_cpu_skinning(cpu_skinning)
+{
+    // instance index is the skin index.
+    for (uint32_t skin = 0; skin < m_skins.size(); ++skin) {
+        m_evaluator.add_instance(skin, find_animation(m_skins[skin], m_animations));
+    }
+
+    m_visible_instances.assign(m_skins.size(), true);
+
+    const auto& meshes = processor.get_meshes();
+    std::vector<int32_t> mesh_nodes(meshes.size(), -1);
+
+    processor.get_graph()->go_though([&mesh_nodes](const std::shared_ptr<gltf::scene_graph::node>& node) {
+        if (node->mesh_index >= 0) {
+            mesh_nodes.at(node->mesh_index) = node->get_node_index();
+        }
+
+        return true;
+    });
+
+    uint32_t subset_index = 0;
+
+    for (uint32_t mesh_index = 0; mesh_index < meshes.size(); ++mesh_index) {
+        const auto& mesh = meshes[mesh_index];
+
+        for (const auto& subset : mesh.get_geom_subsets()) {
+            const auto gl_mesh = subset_index++;
+            m_mesh_instances.emplace_back(is_skinned(mesh, subset) ? mesh.get_skin_index() : -1);
+            const bool is_cpu_skinned = cpu_skinning && is_skinned(mesh, subset);
+            int32_t morphed = -1;
+
+            if ((is_cpu_skinned || !subset.morph_targets.empty()) && (gl_scene.meshes.at(gl_mesh).get_vertex_regions().empty() || !has_float_attributes(subset))) {
+                throw std::runtime_error("animated vertices of mesh " + mesh.get_name() + " need float attributes in vertex regions of their own.");
+            }
+
+            if (!subset.morph_targets.empty()) {
+                const auto node = uint32_t(mesh_nodes[mesh_index]);
+                morphed = m_morphed_subsets.size();
+                m_morphed_subsets.emplace_back(
+                    morphed_subset{&subset, gl_mesh, &mesh.get_weights(), find_morph_animation(node, m_animations), node, is_cpu_skinned});
+            }
+
+            if (!is_skinned(mesh, subset)) {
+                continue;
+            }
+
+            auto& material = gl_scene.materials.at(gl_mesh);
+            material.set_animation(-1);
+
+            if (is_cpu_skinned) {
+                m_skinned_subsets.emplace_back(skinned_subset{&subset, gl_mesh, uint32_t(mesh.get_skin_index()), morphed});
+            } else {
+                m_evaluator.make_palette_texture(gl_scene);
+                m_evaluator.bind_instance(gl_scene, material, mesh.get_skin_index());
+            }
+        }
+    }
+
+    m_stats.instances = m_evaluator.get_instances_count();
+}
+
+
+void gltf::scene_animator::update(float dt, const glm::mat4& view, const glm::mat4& projection, const glm::mat4& model)
+{
+    gl::cpu_zone zone("scene_animator::update");
+
+    m_frustum = ::utils::make_frustum(projection * view);
+    m_model = model;
+
+    morph_subsets(dt);
+
+    if (m_evaluator.get_instances_count() == 0) {
+        return;
+    }
+
+    m_stats.culled_instances = 0;
+
+    // bounds of the pose displayed now, instances without joint bounds are updated every frame.
+    // culled instances get the lowest update rate, their pose is only needed once they are visible again.
+    for (uint32_t i = 0; i < m_evaluator.get_instances_count(); ++i) {
+        const auto bounds = m_evaluator.get_bounds(i, model);
+        auto& instance = m_evaluator.get_instance(i);
+
+        m_visible_instances[i] = bounds.is_empty() || ::utils::is_visible(m_frustum, bounds);
+        m_stats.culled_instances += m_visible_instances[i] ? 0 : 1;
+
+        if (!m_visible_instances[i]) {
+            instance.screen_size = 0;
+        } else {
+            instance.screen_size = bounds.is_empty() ? 1.f : pose_evaluator::get_screen_size(view, projection, bounds.get_center(), glm::length(bounds.get_extents()));
+        }
+    }
+
+    update_skeleton_lods();
+    m_evaluator.update(dt);
+    m_evaluator.upload_palette(m_scene);
+    skin_subsets();
+
+    m_stats.evaluated_instances = m_evaluator.get_evaluated_instances_count();
+}
+
+
+const gltf::scene_animator::frame_stats& gltf::scene_animator::get_stats() const
+{
+    return m_stats;
+}
+
+
+bool gltf::scene_animator::is_mesh_visible(uint32_t gl_mesh) const
+{
+    if (gl_mesh < m_mesh_instances.size() && m_mesh_instances[gl_mesh] >= 0) {
+        return m_visible_instances[m_mesh_instances[gl_mesh]];
+    }
+
+    const auto& bounds = m_scene.meshes.at(gl_mesh).get_bounds();
+
+    return bounds.is_empty() || ::utils::is_visible(m_frustum, ::utils::transform_aabb(m_model, bounds));
+}
+
+
+void gltf::scene_animator::update_skeleton_lods()
+{
+    m_stats.lod_instances = 0;
+
+    if (!m_cpu_skinning) {
+        return;
+    }
+
+    const auto& policy = m_evaluator.get_lod_policy();
+
+    // instances below the full update rate size get the first lod, below the half rate size the last one.
+    for (uint32_t i = 0; i < m_evaluator.get_instances_count(); ++i) {
+        const auto& instance = m_evaluator.get_instance(i);
+        const auto lods_count = int32_t(m_skins.at(instance.skin).lods.size());
+
+        int32_t lod = -1;
+
+        if (lods_count > 0 && instance.screen_size < policy.full_rate_size) {
+            lod = instance.screen_size < policy.half_rate_size ? lods_count - 1 : 0;
+        }
+
+        if (lod != instance.skeleton_lod) {
+            m_evaluator.set_skeleton_lod(i, lod);
+        }
+
+        m_stats.lod_instances += lod >= 0 ? 1 : 0;
+    }
+}
+
+
+void gltf::scene_animator::morph_subsets(float dt)
+{
+    m_stats.morph_deltas = 0;
+    m_time += dt;
+
+    for (auto& curr_subset : m_morphed_subsets) {
+        curr_subset.weights = *curr_subset.default_weights;
+
+        if (curr_subset.animation >= 0) {
+            const auto& animation = m_animations[curr_subset.animation];
+            const auto duration = animation.get_duration();
+            utils::sample_morph_weights(animation, curr_subset.node, duration > 0 ? std::fmod(m_time, duration) : 0, curr_subset.weights);
+        }
+
+        const auto stats = utils::morph_vertices(*curr_subset.subset, curr_subset.weights, curr_subset.vertices);
+
+        if (!stats.blended) {
+            continue;
+        }
+
+        m_stats.morph_deltas += stats.applied_deltas;
+
+        // cpu skinned subsets skin the morphed vertices, the shaders skin the uploaded ones.
+        if (!curr_subset.is_cpu_skinned) {
+            upload_vertices(m_scene, *curr_subset.subset, curr_subset.gl_mesh, curr_subset.vertices);
+        }
+    }
+}
+
+
+void gltf::scene_animator::skin_subsets()
+{
+    m_stats.skinned_vertices = 0;
+
+    const auto& palette = m_evaluator.get_palette();
+    const auto stride = m_evaluator.get_palette_stride();
+
+    for (auto& curr_subset : m_skinned_subsets) {
+        if (!m_visible_instances[curr_subset.instance]) {
+            continue;
+        }
+
+        const auto skin_lod = m_evaluator.get_instance(curr_subset.instance).skeleton_lod;
+        const auto stats = utils::skin_vertices(
+            *curr_subset.subset,
+            palette.data() + curr_subset.instance * stride,
+            stride,
+            curr_subset.vertices,
+            &m_pool,
+            4096,
+            curr_subset.morphed >= 0 ? &m_morphed_subsets[curr_subset.morphed].vertices : nullptr,
+            skin_lod);
+        upload_vertices(m_scene, *curr_subset.subset, curr_subset.gl_mesh, curr_subset.vertices);
+        m_stats.skinned_vertices += stats.vertices_count;
+    }
+}
@@ -0,0 +1,96 @@
+
+
+#pragma once
+
+#include <gltf/meshes_processor.hpp>
+#include <gltf/pose_evaluator.hpp>
+#include <gltf/misc/skinning.hpp>
+
+#include <gl/scene/scene.hpp>
+
+#include <worker_pool.hpp>
+
+#include <glm/mat4x4.hpp>
+
+#include <vector>
+
+namespace gltf
+{
+    // animates the skinned meshes of a parsed scene every frame, with one pose evaluator instance per skin.
+    // meshes and materials of the gl scene are expected in gl_scene_builder order, one per subset.
+    class scene_animator
+    {
+    public:
+        struct frame_stats
+        {
+            uint32_t instances = 0;
+            uint32_t evaluated_instances = 0;
+            // instances outside of the frustum, they are updated at the lowest rate and not skinned on the cpu.
+            uint32_t culled_instances = 0;
+            // instances evaluated with a reduced skeleton.
+            uint32_t lod_instances = 0;
+            size_t skinned_vertices = 0;
+            // deltas of the subsets blended again, their weights changed.
+            size_t morph_deltas = 0;
+        };
+
+        // materials of skinned subsets sample the evaluated palette instead of the baked clips.
+        // with cpu skinning the subsets are skinned by utils::skin_vertices into their vertex regions instead,
+        // their materials must be built without the skinning variant then.
+        // skin lods are used only with cpu skinning, shaders read JOINTS_0 of the full skeleton.
+        // subsets with morph targets are blended on the cpu with the weights of the first animation driving
+        // their node, or the default weights of their mesh, and uploaded unless they are skinned on the cpu.
+        scene_animator(const meshes_processor& processor, gl::scene::scene& gl_scene, ::utils::worker_pool& pool, bool cpu_skinning = false);
+        ~scene_animator() = default;
+
+        // the camera and the model transform of the scene give the screen size of every instance, see pose_evaluator::lod_policy.
+        void update(float dt, const glm::mat4& view, const glm::mat4& projection, const glm::mat4& model);
+        const frame_stats& get_stats() const;
+        // skinned meshes are tested with the bounds of their instance pose, others with their own bounds,
+        // against the frustum of the last update. meshes without bounds are always visible.
+        bool is_mesh_visible(uint32_t gl_mesh) const;
+
+    private:
+        struct skinned_subset
+        {
+            const mesh::geom_subset* subset;
+            uint32_t gl_mesh;
+            uint32_t instance;
+            // index of the morphed subset skinned instead of the subset attributes, -1 if it has no targets.
+            int32_t morphed;
+            utils::skinned_vertices vertices{};
+        };
+
+        struct morphed_subset
+        {
+            const mesh::geom_subset* subset;
+            uint32_t gl_mesh;
+            const std::vector<float>* default_weights;
+            int32_t animation;
+            uint32_t node;
+            bool is_cpu_skinned;
+            std::vector<float> weights{};
+            utils::morphed_vertices vertices{};
+        };
+
+        void update_skeleton_lods();
+        void morph_subsets(float dt);
+        void skin_subsets();
+
+        gl::scene::scene& m_scene;
+        ::utils::worker_pool& m_pool;
+        const std::vector<skin>& m_skins;
+        const std::vector<animation>& m_animations;
+        pose_evaluator m_evaluator;
+        bool m_cpu_skinning;
+        std::vector<skinned_subset> m_skinned_subsets;
+        std::vector<morphed_subset> m_morphed_subsets;
+        float m_time{0};
+        // instance of every gl mesh, -1 if it is not skinned.
+        std::vector<int32_t> m_mesh_instances;
+        std::vector<bool> m_visible_instances;
+        ::utils::frustum m_frustum{};
+        glm::mat4 m_model{1};
+        frame_stats m_stats{};
+    };
+} // namespace gltf
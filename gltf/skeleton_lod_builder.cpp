@@ -0,0 +1,188 @@
+
+
+#include "skeleton_lod_builder.hpp"
+
+#include <gltf/misc/vertex_utils.hpp>
+
+
+gltf::skeleton_lod_builder::skeleton_lod_builder(std::vector<settings> lods)
+    : m_lods(std::move(lods))
+{
+}
+
+
+void gltf::skeleton_lod_builder::make_lods(gltf::skin& skin, int32_t skin_index, std::vector<gltf::mesh>& meshes) const
+{
+    const auto joints_count = skin.get_joints().size();
+    std::vector<float> importance(joints_count, 0.f);
+
+    for (const auto& mesh : meshes) {
+        if (mesh.get_skin_index() != skin_index) {
+            continue;
+        }
+
+        for (const auto& subset : mesh.get_geom_subsets()) {
+            if (subset.joints.data.empty() || subset.weights.data.empty()) {
+                continue;
+            }
+
+            const auto vertices_count = utils::get_vertices_count(subset.joints);
+
+            for (size_t v = 0; v < vertices_count; ++v) {
+                uint32_t joints[4];
+                float weights[4];
+                utils::read_influences(subset.joints, subset.weights, v, joints, weights);
+
+                for (size_t i = 0; i < 4; ++i) {
+                    if (joints[i] < joints_count) {
+                        importance[joints[i]] += weights[i];
+                    }
+                }
+            }
+        }
+    }
+
+    for (const auto& lod_settings : m_lods) {
+        const auto& lod = skin.lods.emplace_back(make_lod(skin, importance, lod_settings));
+
+        for (auto& mesh : meshes) {
+            if (mesh.get_skin_index() != skin_index) {
+                continue;
+            }
+
+            for (auto& subset : mesh.get_geom_subsets()) {
+                if (!subset.joints.data.empty() && !subset.weights.data.empty()) {
+                    remap_subset(subset, lod);
+                }
+            }
+        }
+    }
+}
+
+
+gltf::skin::lod gltf::skeleton_lod_builder::make_lod(
+    const gltf::skin& skin,
+    const std::vector<float>& importance,
+    const gltf::skeleton_lod_builder::settings& lod_settings) const
+{
+    const auto& joints = skin.get_joints();
+    const auto& order = skin.get_evaluation_order();
+
+    std::vector<bool> kept(joints.size(), true);
+
+    if (lod_settings.rule == collapse_rule::depth) {
+        std::vector<uint32_t> depths(joints.size(), 0);
+
+        for (const auto joint : order) {
+            const auto parent = joints[joint].parent;
+            depths[joint] = parent >= 0 ? depths[parent] + 1 : 0;
+            kept[joint] = depths[joint] <= lod_settings.max_depth;
+        }
+    } else {
+        std::vector<float> accumulated = importance;
+        std::vector<uint32_t> kept_children(joints.size(), 0);
+        float total = 0;
+
+        for (size_t joint = 0; joint < joints.size(); ++joint) {
+            total += importance[joint];
+
+            if (joints[joint].parent >= 0) {
+                ++kept_children[joints[joint].parent];
+            }
+        }
+
+        const float threshold = total * lod_settings.min_importance;
+
+        // children go before their parents in reversed order, so a parent sees all collapses of its subtree.
+        for (auto it = order.rbegin(); it != order.rend(); ++it) {
+            const auto joint = *it;
+            const auto parent = joints[joint].parent;
+
+            if (parent < 0 || kept_children[joint] > 0 || accumulated[joint] >= threshold) {
+                continue;
+            }
+
+            kept[joint] = false;
+            accumulated[parent] += accumulated[joint];
+            --kept_children[parent];
+        }
+    }
+
+    skin::lod lod;
+    lod.joints_map.resize(joints.size(), 0);
+
+    for (uint32_t joint = 0; joint < joints.size(); ++joint) {
+        if (kept[joint]) {
+            lod.joints_map[joint] = lod.joints.size();
+            lod.joints.emplace_back(joint);
+        }
+    }
+
+    for (const auto joint : order) {
+        if (!kept[joint]) {
+            lod.joints_map[joint] = lod.joints_map[joints[joint].parent];
+        }
+    }
+
+    return lod;
+}
+
+
+void gltf::skeleton_lod_builder::remap_subset(gltf::mesh::geom_subset& subset, const gltf::skin::lod& lod)
+{
+    const auto vertices_count = utils::get_vertices_count(subset.joints);
+    const bool is_u8 = lod.joints.size() <= 256;
+
+    auto& subset_lod = subset.skin_lods.emplace_back();
+
+    subset_lod.joints.c_type = is_u8 ? data_storage::component_type::u8 : data_storage::component_type::u16;
+    subset_lod.joints.d_type = data_storage::type::vec4;
+    subset_lod.joints.normalized = false;
+    subset_lod.joints.data.resize(vertices_count * 4 * (is_u8 ? sizeof(uint8_t) : sizeof(uint16_t)));
+
+    subset_lod.weights.c_type = data_storage::component_type::f32;
+    subset_lod.weights.d_type = data_storage::type::vec4;
+    subset_lod.weights.normalized = false;
+    subset_lod.weights.data.resize(vertices_count * 4 * sizeof(float));
+
+    auto dst_weights = reinterpret_cast<float*>(subset_lod.weights.data.data());
+
+    for (size_t v = 0; v < vertices_count; ++v) {
+        uint32_t joints[4];
+        float weights[4];
+        utils::read_influences(subset.joints, subset.weights, v, joints, weights);
+
+        uint32_t lod_joints[4]{0, 0, 0, 0};
+        float lod_weights[4]{0, 0, 0, 0};
+        uint32_t influences = 0;
+
+        // influences collapsed into the same joint are merged.
+        for (size_t i = 0; i < 4; ++i) {
+            if (weights[i] <= 0 || joints[i] >= lod.joints_map.size()) {
+                continue;
+            }
+
+            const auto lod_joint = lod.joints_map[joints[i]];
+            const auto found = std::find(lod_joints, lod_joints + influences, lod_joint);
+
+            if (found != lod_joints + influences) {
+                lod_weights[found - lod_joints] += weights[i];
+            } else {
+                lod_joints[influences] = lod_joint;
+                lod_weights[influences] = weights[i];
+                ++influences;
+            }
+        }
+
+        for (size_t i = 0; i < 4; ++i) {
+            if (is_u8) {
+                subset_lod.joints.data[v * 4 + i] = lod_joints[i];
+            } else {
+                const uint16_t joint = lod_joints[i];
+                std::memcpy(subset_lod.joints.data.data() + (v * 4 + i) * sizeof(uint16_t), &joint, sizeof(joint));
+            }
+
+            dst_weights[v * 4 + i] = lod_weights[i];
+        }
+    }
+}
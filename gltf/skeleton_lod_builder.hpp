@@ -0,0 +1,42 @@
+
+
+#pragma once
+
+#include <gltf/mesh.hpp>
+#include <gltf/skin.hpp>
+
+#include <vector>
+
+namespace gltf
+{
+    class skeleton_lod_builder
+    {
+    public:
+        enum class collapse_rule
+        {
+            // joints deeper than max_depth collapse into their ancestor at max_depth.
+            depth,
+            // leaf joints carrying less than min_importance of the skin weights collapse into their parents.
+            importance
+        };
+
+        struct settings
+        {
+            collapse_rule rule = collapse_rule::importance;
+            uint32_t max_depth = 4;
+            float min_importance = 0.01f;
+        };
+
+        explicit skeleton_lod_builder(std::vector<settings> lods);
+        ~skeleton_lod_builder() = default;
+
+        // fills skin lods and remaps JOINTS_0/WEIGHTS_0 of the subsets of the meshes skinned by it.
+        void make_lods(skin& skin, int32_t skin_index, std::vector<mesh>& meshes) const;
+
+    private:
+        skin::lod make_lod(const skin& skin, const std::vector<float>& importance, const settings& lod_settings) const;
+        static void remap_subset(mesh::geom_subset& subset, const skin::lod& lod);
+
+        std::vector<settings> m_lods;
+    };
+} // namespace gltf
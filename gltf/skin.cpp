@@ -27,6 +27,56 @@ gltf::skin::skin(const tinygltf::Model& model, const tinygltf::Skin& skin, const
         m_inv_bind_poses,
         model,
         skin.inverseBindMatrices);
+
+    m_joints.resize(m_nodes.size());
+
+    for (size_t i = 0; i < m_nodes.size(); ++i) {
+        auto& curr_joint = m_joints[i];
+        const auto& node = m_nodes[i];
+
+        curr_joint.translation = node->translation;
+        curr_joint.rotation = node->rotation;
+        curr_joint.scale = node->scale;
+
+        for (auto parent = node->get_parent(); parent != nullptr; parent = parent->get_parent()) {
+            const auto parent_it = std::find(m_nodes.begin(), m_nodes.end(), parent);
+
+            if (parent_it != m_nodes.end()) {
+                curr_joint.parent = parent_it - m_nodes.begin();
+                break;
+            }
+
+            auto ancestor_it = std::find(m_ancestors.begin(), m_ancestors.end(), parent);
+
+            if (ancestor_it == m_ancestors.end()) {
+                ancestor_it = m_ancestors.insert(m_ancestors.end(), parent);
+            }
+
+            curr_joint.ancestors.emplace_back(ancestor_it - m_ancestors.begin());
+            curr_joint.parent_transform = parent->get_local_transformation() * curr_joint.parent_transform;
+        }
+    }
+
+    std::vector<bool> visited(m_joints.size(), false);
+    m_evaluation_order.reserve(m_joints.size());
+
+    const std::function<void(uint32_t)> visit = [this, &visited, &visit](uint32_t joint) {
+        if (visited[joint]) {
+            return;
+        }
+
+        visited[joint] = true;
+
+        if (m_joints[joint].parent >= 0) {
+            visit(m_joints[joint].parent);
+        }
+
+        m_evaluation_order.emplace_back(joint);
+    };
+
+    for (uint32_t i = 0; i < m_joints.size(); ++i) {
+        visit(i);
+    }
 }
 
 
@@ -46,3 +96,21 @@ const std::vector<std::shared_ptr<gltf::scene_graph::node>>& gltf::skin::get_nod
 {
     return m_nodes;
 }
+
+
+const std::vector<gltf::skin::joint>& gltf::skin::get_joints() const
+{
+    return m_joints;
+}
+
+
+const std::vector<std::shared_ptr<gltf::scene_graph::node>>& gltf::skin::get_ancestors() const
+{
+    return m_ancestors;
+}
+
+
+const std::vector<uint32_t>& gltf::skin::get_evaluation_order() const
+{
+    return m_evaluation_order;
+}
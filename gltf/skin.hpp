@@ -4,6 +4,8 @@
 
 #include <gltf/gltf_graph.hpp>
 
+#include <bounds.hpp>
+
 #include <glm/mat4x4.hpp>
 
 #include <string>
@@ -26,18 +28,52 @@ namespace gltf
             std::vector<glm::mat4> keys;
         };
 
+        struct joint
+        {
+            // index of the parent joint in the skin, -1 if the parent node is not a joint.
+            int32_t parent = -1;
+            // nodes between the joint and its parent joint (or the scene root), closest first, indices into get_ancestors().
+            std::vector<uint32_t> ancestors;
+            // transformation of these nodes at rest.
+            glm::mat4 parent_transform{1};
+
+            glm::vec3 translation{0, 0, 0};
+            glm::quat rotation{1, 0, 0, 0};
+            glm::vec3 scale{1, 1, 1};
+        };
+
+        // reduced joints set, collapsed joints are skinned by their kept ancestor.
+        struct lod
+        {
+            // skin joint index of every kept joint.
+            std::vector<uint32_t> joints;
+            // lod joint index for every skin joint.
+            std::vector<uint32_t> joints_map;
+        };
+
         skin(const tinygltf::Model& model, const tinygltf::Skin& skin, const scene_graph& graph);
         ~skin() = default;
         const std::string& get_name() const;
         const std::vector<glm::mat4>& get_nodes_matrices() const;
         const std::vector<std::shared_ptr<scene_graph::node>>& get_nodes() const;
+        const std::vector<joint>& get_joints() const;
+        // nodes above the joints which are not joints themselves, animations may move them too.
+        const std::vector<std::shared_ptr<scene_graph::node>>& get_ancestors() const;
+        // joints order where every parent goes before its children.
+        const std::vector<uint32_t>& get_evaluation_order() const;
 
         std::vector<animation> animations;
+        std::vector<lod> lods;
+        // mesh space bounds of the vertices influenced by every joint, empty if the joint skins nothing.
+        std::vector<::utils::aabb> joints_bounds;
 
     private:
         std::string m_name;
         std::vector<glm::mat4> m_inv_bind_poses;
         std::vector<std::shared_ptr<scene_graph::node>> m_nodes;
+        std::vector<joint> m_joints;
+        std::vector<std::shared_ptr<scene_graph::node>> m_ancestors;
+        std::vector<uint32_t> m_evaluation_order;
     };
 
 
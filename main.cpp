@@ -1,8 +1,19 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <backend/glfw_context.hpp>
+#ifdef GL_SANDBOX_EGL
+    #include <backend/egl_context.hpp>
+#endif
+
 #include <assimp_handlers.hpp>
 #include <gltf/camera.hpp>
 
@@ -18,6 +29,16 @@
 #include <gltf/common_parameters_builder.hpp>
 #include <gltf/common_drawables_builder.hpp>
 #include <gltf/common_commands_builder.hpp>
+#include <gltf/common_animations_builder.hpp>
+#include <gltf/scene_animator.hpp>
+
+#include <gl/debug.hpp>
+#include <gl/profiler.hpp>
+#include <gl/scene/render_queue.hpp>
+#include <gl/scene/command_list.hpp>
+#include <gl/scene/resolution_controller.hpp>
+
+#include <worker_pool.hpp>
 
 
 
@@ -92,40 +113,126 @@ void scroll_callback(GLFWwindow* window, double xoffset, double yoffset)
     view_pos += offset_vec;
 }
 
-int main()
+// gl_sandbox [--headless] [--size WxH] [--frames N] [--output file.png] [--profile trace.json [--profile-draws]] [--baked-animation | --cpu-skinning]
+struct options
 {
-    glfwInit();
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 1);
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#ifdef __APPLE__
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#endif
+    bool headless{false};
+    uint32_t width{800};
+    uint32_t height{600};
+    // 0 runs until the window is closed, a headless run without frames renders one.
+    uint32_t frames{0};
+    // the last frame is written to it.
+    std::string output;
+    // chrome trace of the run, percentiles of the zones are printed at exit.
+    std::string profile;
+    bool profile_draws{false};
+    // plays the clips baked into s_anim at import instead of evaluating poses every frame.
+    bool baked_animation{false};
+    // skins evaluated poses on the cpu and uploads the vertices, shaders do not skin then.
+    bool cpu_skinning{false};
+};
+
+options parse_options(int argc, char** argv)
+{
+    options opts;
+
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (arg == "--headless") {
+            opts.headless = true;
+        } else if (arg == "--size" && has_value) {
+            if (std::sscanf(argv[++i], "%ux%u", &opts.width, &opts.height) != 2 || opts.width == 0 || opts.height == 0) {
+                throw std::runtime_error("invalid size " + std::string(argv[i]));
+            }
+        } else if (arg == "--frames" && has_value) {
+            opts.frames = std::stoul(argv[++i]);
+        } else if (arg == "--output" && has_value) {
+            opts.output = argv[++i];
+        } else if (arg == "--profile" && has_value) {
+            opts.profile = argv[++i];
+        } else if (arg == "--profile-draws") {
+            opts.profile_draws = true;
+        } else if (arg == "--baked-animation") {
+            opts.baked_animation = true;
+        } else if (arg == "--cpu-skinning") {
+            opts.cpu_skinning = true;
+        } else {
+            throw std::runtime_error("unknown option " + arg);
+        }
+    }
+
+    if (opts.baked_animation && opts.cpu_skinning) {
+        throw std::runtime_error("baked animation is skinned by shaders, it can not be skinned on the cpu");
+    }
+
+    if (opts.headless && opts.frames == 0) {
+        opts.frames = 1;
+    }
 
-    auto window = glfwCreateWindow(800, 600, "gl sandbox", nullptr, nullptr);
-    glfwMakeContextCurrent(window);
+    return opts;
+}
+
+std::unique_ptr<backend::context> make_context(const options& opts)
+{
+    if (opts.headless) {
+#ifdef GL_SANDBOX_EGL
+        return std::make_unique<backend::egl_context>(opts.width, opts.height, opts.frames);
+#else
+        throw std::runtime_error("headless rendering needs a build with GL_SANDBOX_EGL");
+#endif
+    }
 
-    glfwSetScrollCallback(window, scroll_callback);
+    return std::make_unique<backend::glfw_context>(opts.width, opts.height, "gl sandbox");
+}
 
-    if (!gladLoadGLLoader((GLADloadproc) glfwGetProcAddress)) {
-        std::cout << "Failed to initialize GLAD" << std::endl;
+int main(int argc, char** argv)
+{
+    options opts;
+    std::unique_ptr<backend::context> context;
+
+    try {
+        opts = parse_options(argc, argv);
+        context = make_context(opts);
+    } catch (const std::exception& e) {
+        std::cout << e.what() << std::endl;
         return -1;
     }
+
+    // input comes from the window only, headless runs keep the initial camera.
+    GLFWwindow* window = nullptr;
+
+    if (const auto* glfw = dynamic_cast<const backend::glfw_context*>(context.get())) {
+        window = glfw->get_window();
+        glfwSetScrollCallback(window, scroll_callback);
+    }
+
     {
         float anim_key = 0;
         gl::scene::scene scene;
+        // linked programs are kept in the working directory, a warm start from it does not compile glsl.
+        scene.programs.set_directory("program_cache");
 
         gltf::gltf_parser p {
             {
                 std::make_unique<gltf::adj_mesh_builder>(),
-                std::make_unique<gltf::custom_material_builder>(),
+                std::make_unique<gltf::custom_material_builder>(!opts.cpu_skinning),
                 std::make_unique<gltf::common_parameters_builder>(),
                 std::make_unique<gltf::common_images_builder>(),
                 std::make_unique<gltf::common_drawables_builder>(),
-                std::make_unique<gltf::common_commands_builder>()
+                std::make_unique<gltf::common_commands_builder>(),
+                std::make_unique<gltf::common_animations_builder>()
             }
         };
 
+        // reduced skeletons for small instances, they are skinned on the cpu only.
+        if (opts.cpu_skinning) {
+            p.set_skeleton_lods({
+                gltf::skeleton_lod_builder::settings{},
+                gltf::skeleton_lod_builder::settings{gltf::skeleton_lod_builder::collapse_rule::depth, 3}});
+        }
+
         p.parse(
             "/Users/vladislavkhudiakov/Downloads/sphere2/scene.gltf",
             "/Users/vladislavkhudiakov/Documents/dev/gl_sandbox/models/hdr/newport_loft.hdr",
@@ -133,15 +240,67 @@ int main()
 
         gltf::camera cam(0, 1, scene);
 
-        assert(glGetError() == GL_NO_ERROR);
+        GL_CHECK_ERRORS();
+
+        gl::scene::render_queue queue(scene);
+        std::vector<gl::scene::render_command> sorted_commands;
+        // recompiled only when the sorted commands change, recorded in chunks on the workers.
+        gl::scene::command_list compiled_commands;
+        utils::worker_pool workers;
+
+        std::optional<gltf::scene_animator> animator;
+        // animator stats summed over the frames, printed per frame at exit.
+        uint64_t evaluated_instances = 0;
+        uint64_t culled_instances = 0;
+        uint64_t lod_instances = 0;
+        uint64_t skinned_vertices = 0;
+        uint64_t morph_deltas = 0;
+        uint32_t animated_frames = 0;
+
+        if (!opts.baked_animation) {
+            animator.emplace(p.get_processor(), scene, workers, opts.cpu_skinning);
+        }
+
+        // per frame parameters are found by interned names, without hashing strings.
+        const auto mvp_name = gl::scene::intern("u_MVP");
+        const auto model_name = gl::scene::intern("u_MODEL");
+        const auto anim_key_name = gl::scene::intern("u_ANIM_KEY");
+
+        // the last pass is the one blitted to the surface, its render size follows the frame time.
+        auto present_pass = std::find_if(scene.commands.rbegin(), scene.commands.rend(), [](const gl::scene::render_command& c) {
+            return c.type == gl::scene::render_command::type::pass;
+        });
+        assert(present_pass != scene.commands.rend());
+        gl::scene::resolution_controller resolution(scene, scene.passes.at(present_pass->source_index).get_framebuffer_idx());
+
+        std::optional<gl::profiler> profiler;
+
+        if (!opts.profile.empty()) {
+            profiler.emplace();
+            profiler->set_draw_zones(opts.profile_draws);
+            gl::profiler::set_current(&*profiler);
+        }
+
+        auto frame_start = std::chrono::steady_clock::now();
+
+        for (uint32_t frame = 0; !context->should_close() && (opts.frames == 0 || frame < opts.frames); ++frame) {
+            const auto now = std::chrono::steady_clock::now();
+            const float dt = std::chrono::duration<float>(now - frame_start).count();
+            frame_start = now;
+
+            if (profiler) {
+                profiler->begin_frame();
+            }
 
-        while (!glfwWindowShouldClose(window)) {
             {
-                process_camera(window, scene);
+                gl::cpu_zone frame_zone("frame");
+
+                if (window != nullptr) {
+                    process_camera(window, scene);
+                }
                 cam.m_position = view_pos;
                 cam.m_direction = view_pos + camera_dir;
-                int32_t window_fb_width, window_fb_height;
-                glfwGetFramebufferSize(window, &window_fb_width, &window_fb_height);
+                const auto [window_fb_width, window_fb_height] = context->get_surface_size();
                 cam.update(window_fb_width, window_fb_height);
 
                 auto rotation_x = glm::rotate(glm::mat4{1}, rot.x, {1.f, 0.f, 0.f});
@@ -150,41 +309,105 @@ int main()
 
                 auto rotation = rotation_z * rotation_y * rotation_x;
 
-                for (const auto& mat : scene.materials) {
-                    const auto& mat_params = mat.get_parameters();
-                    auto mvp_it = mat_params.find("u_MVP");
+                const auto mvp = cam.m_proj_matrix * cam.m_view_matrix * rotation;
 
-                    if (mvp_it != mat_params.end()) {
-                        auto& param = scene.parameters.at(mvp_it->second);
-                        auto mvp = cam.m_proj_matrix * cam.m_view_matrix * rotation;
-                        std::memcpy(param.get_data(), glm::value_ptr(mvp), sizeof(mvp));
-                    }
+                if (animator) {
+                    animator->update(dt, cam.m_view_matrix, cam.m_proj_matrix, rotation);
+                    evaluated_instances += animator->get_stats().evaluated_instances;
+                    culled_instances += animator->get_stats().culled_instances;
+                    lod_instances += animator->get_stats().lod_instances;
+                    skinned_vertices += animator->get_stats().skinned_vertices;
+                    morph_deltas += animator->get_stats().morph_deltas;
+                    ++animated_frames;
+                }
 
-                    auto model_it = mat_params.find("u_MODEL");
+                {
+                    gl::cpu_zone parameters_zone("parameters");
 
-                    if (model_it != mat_params.end()) {
-                        auto& param = scene.parameters.at(model_it->second);
-                        std::memcpy(param.get_data(), glm::value_ptr(rotation), sizeof(rotation));
-                    }
+                    for (const auto& mat : scene.materials) {
+                        if (const auto param = mat.find_parameter(mvp_name); param >= 0) {
+                            scene.parameters.set(param, mvp);
+                        }
+
+                        if (const auto param = mat.find_parameter(model_name); param >= 0) {
+                            scene.parameters.set(param, rotation);
+                        }
 
-                    auto anim_it = mat_params.find("u_ANIM_KEY");
-                    if (anim_it != mat_params.end()) {
-                        auto& param = scene.parameters.at(anim_it->second);
-                        auto anim_ptr = (int32_t*) (param.get_data());
-                        int32_t iaim_key = anim_key;
-                        *anim_ptr = iaim_key;
+                        // every skin plays the last clip of its own animation.
+                        if (const auto param = mat.find_parameter(anim_key_name); param >= 0 && mat.get_animation() >= 0) {
+                            const auto& clip = scene.animations.at(mat.get_animation()).clips.back();
+                            scene.parameters.set(param, int32_t(clip.first_key + uint32_t(anim_key) % clip.keys_count));
+                        }
                     }
                 }
 
-                gl::scene::draw(scene, window_fb_width, window_fb_height);
-                glfwSwapBuffers(window);
-                glfwPollEvents();
+                // view depth of the drawable bounds center, drawables without bounds (the environment) are at the camera.
+                const auto model_view = cam.m_view_matrix * rotation;
+                const auto get_view_depth = [&scene, &model_view](uint32_t drawable) {
+                    const auto& bounds = scene.meshes.at(scene.drawables.at(drawable).mesh_idx).get_bounds();
+                    return bounds.is_empty() ? 0.f : -(model_view * glm::vec4{bounds.get_center(), 1.f}).z;
+                };
+
+                queue.clear();
+                queue.set_depth_range(cam.m_near, cam.m_far);
+                // without the animator skinned drawables have no pose bounds, nothing is culled then.
+                queue.push_commands(scene.commands, get_view_depth, [&scene, &animator](uint32_t drawable) {
+                    return !animator || animator->is_mesh_visible(scene.drawables.at(drawable).mesh_idx);
+                });
+                queue.sort();
+                sorted_commands.clear();
+                queue.make_commands(sorted_commands);
+
+                resolution.begin_frame();
+                compiled_commands.update(scene, sorted_commands, &workers);
+                compiled_commands.replay(scene, window_fb_width, window_fb_height, context->get_surface_framebuffer());
+                resolution.end_frame();
+
+                if (profiler) {
+                    profiler->end_frame();
+                }
+
+                if (!opts.output.empty() && frame + 1 == opts.frames) {
+                    context->write_png(opts.output);
+                }
+
+                if (resolution.update(window_fb_width, window_fb_height)) {
+                    compiled_commands.invalidate();
+                }
+
+                context->present();
                 anim_key += 0.5;
             }
         }
 
-        glfwDestroyWindow(window);
-        glfwTerminate();
+        if (animator && animated_frames > 0) {
+            const auto& stats = animator->get_stats();
+            std::printf(
+                "animation: %u instances, per frame %.2f evaluated, %.2f culled, %.2f with a skeleton lod, %.0f vertices skinned on the cpu, %.0f morph deltas\n",
+                stats.instances,
+                double(evaluated_instances) / animated_frames,
+                double(culled_instances) / animated_frames,
+                double(lod_instances) / animated_frames,
+                double(skinned_vertices) / animated_frames,
+                double(morph_deltas) / animated_frames);
+        }
+
+        if (profiler) {
+            gl::profiler::set_current(nullptr);
+            profiler->flush();
+            profiler->write_trace(opts.profile);
+
+            for (const auto& stats : profiler->get_stats()) {
+                std::printf(
+                    "%s %-48s %6u samples  p50 %8.3f ms  p95 %8.3f ms  p99 %8.3f ms\n",
+                    stats.line == gl::profiler::timeline::cpu ? "cpu" : "gpu",
+                    stats.name.c_str(),
+                    stats.samples,
+                    stats.p50_ms,
+                    stats.p95_ms,
+                    stats.p99_ms);
+            }
+        }
     }
 
     return 0;
@@ -515,19 +515,50 @@ layout (location = 3) in vec3 attr_tangent;
 layout (location = 4) in vec4 attr_bones;
 layout (location = 5) in vec4 attr_weights;
 
-//#define ANIM
+// features are defined by the material, see gltf::make_pbr_sources.
 
 out vec2 var_uv;
 out vec3 var_v;
 out vec3 var_n;
+
+#ifdef NORMAL_MAP
 out vec3 var_t;
 out vec3 var_b;
+#endif
 
-uniform mat4 u_MVP;
-uniform mat4 u_MODEL;
+#ifdef VERTEX_COLORS
+layout (location = 7) in vec4 attr_color;
+out vec4 var_color;
+#endif
+
+#ifdef MULTI_DRAW
+layout (location = 8) in float attr_draw_slot;
+
+uniform samplerBuffer s_draw_data;
+
+mat4 get_draw_matrix(int texel)
+{
+  int base = int(attr_draw_slot) * 9 + texel;
+  return mat4(
+    texelFetch(s_draw_data, base),
+    texelFetch(s_draw_data, base + 1),
+    texelFetch(s_draw_data, base + 2),
+    texelFetch(s_draw_data, base + 3));
+}
+
+#define u_MVP get_draw_matrix(0)
+#define u_MODEL get_draw_matrix(4)
+#define u_ANIM_KEY int(texelFetch(s_draw_data, int(attr_draw_slot) * 9 + 8).x)
+#else
+layout (std140) uniform draw_data
+{
+  mat4 u_MVP;
+  mat4 u_MODEL;
+  int u_ANIM_KEY;
+};
+#endif
 
 #ifdef ANIM
-uniform int u_ANIM_KEY;
 uniform sampler2D s_anim;
 
 mat4 get_anim_matrix(int bone_idx, int key)
@@ -565,127 +596,19 @@ void main()
   gl_Position = u_MVP * vec4(pos, 1.);
   var_n = vec3(model_transform * vec4(attr_normal, 0.));
 
+#ifdef NORMAL_MAP
   var_t = vec3(model_transform * vec4(attr_tangent, 0.));
   var_t = normalize(var_t - var_n * max(dot(var_n, var_t), 0.));
   var_b = cross(var_n, var_t);
+#endif
+
+#ifdef VERTEX_COLORS
+  var_color = attr_color;
+#endif
 
   var_v = vec3(model_transform * vec4(attr_pos, 1.));
   var_uv = attr_uv;
 }
-)";
-
-    inline constexpr static auto* pbr_fss = R"(#version 410 core
-layout (location = 0) out vec4 frag_color;
-
-in vec2 var_uv;
-in vec3 var_v;
-in vec3 var_n;
-in vec3 var_t;
-in vec3 var_b;
-
-struct light
-{
-  vec3 position;
-  vec3 color;
-};
-
-uniform float u_roughness;
-uniform float u_metalness;
-uniform vec3 u_albedo;
-uniform vec3 u_cam_pos;
-
-uniform sampler2D s_albedo;
-uniform sampler2D s_mrao;
-uniform sampler2D s_normal;
-
-uniform light u_light_sources[4];
-
-const float PI = 3.14159265359;
-
-vec3 fresnel_schlick(float cos_theta, vec3 F0)
-{
-    return F0 + (1.0 - F0) * pow(1.0 - cos_theta, 5.0);
-}
-
-float distribution_ggx(vec3 N, vec3 H, float roughness)
-{
-    float a = roughness * roughness;
-    float a2 = a * a;
-    float NdotH  = max(dot(N, H), 0.0);
-    float NdotH2 = NdotH*NdotH;
-
-    float nom = a2;
-    float denom = (NdotH2 * (a2 - 1.0) + 1.0);
-    denom = PI * denom * denom;
-
-    return nom / denom;
-}
-
-float geometry_schlick_ggx(float NdotV, float roughness)
-{
-    float r = (roughness + 1.0);
-    float k = (r * r) / 8.0;
-
-    float nom = NdotV;
-    float denom = NdotV * (1.0 - k) + k;
-
-    return nom / denom;
-}
-
-float geometry_smith(vec3 N, vec3 V, vec3 L, float roughness)
-{
-    float NdotV = max(dot(N, V), 0.0);
-    float NdotL = max(dot(N, L), 0.0);
-    float ggx2 = geometry_schlick_ggx(NdotV, roughness);
-    float ggx1 = geometry_schlick_ggx(NdotL, roughness);
-
-    return NdotV;
-}
-
-vec3 g2l(vec3 src)
-{
-  return pow(vec3(1.) - exp(-src * 1.), vec3(1. / 2.2));
-}
-
-void main()
-{
-  vec3 N = normalize(mat3(var_t, var_b, var_n) * (texture(s_normal, var_uv).xyz * 2. - 1.));
-
-  vec3 V = normalize(u_cam_pos - var_v);
-  vec3 F0 = vec3(0.04);
-  vec3 albedo = texture(s_albedo, var_uv).rgb;
-  vec4 mrao = texture(s_mrao, var_uv);
-
-  float metallic = mrao.r;
-  float roughness = mrao.g;
-
-  F0 = mix(F0, albedo, metallic);
-
-  vec3 Lo = vec3(0.0);
-  for (int i = 0; i < 4; ++i) {
-    vec3 L = normalize(u_light_sources[i].position - var_v);
-    vec3 H = normalize(V + L);
-    float dist = length(u_light_sources[i].position - var_v);
-    vec3 R = u_light_sources[i].color * (1. / pow(dist, 2));
-
-    vec3 F = fresnel_schlick(clamp(dot(H, V), 0.0, 1.0), F0);
-    float D = distribution_ggx(N, H, roughness);
-    float G = geometry_smith(N, V, L, roughness);
-
-    vec3 nom = F * D * G;
-    float denom = 4. * max(max(dot(N, V), 0.0) * max(dot(N, L), 0.0), 0.001);
-    vec3 BRDF = nom / denom;
-    vec3 kS = F;
-    vec3 kD = (1. - kS) * (1. - metallic);
-
-    float NdotL = max(dot(N, L), 0.0);
-    Lo += (kD * albedo / PI + BRDF) * R * NdotL;
-  }
-
-  vec3 ambeint = albedo * 0.03 + Lo;
-
-  frag_color = vec4(g2l(ambeint), 1.);
-}
 )";
 
     inline constexpr static auto* solid_fss = R"(#version 410 core
@@ -724,8 +647,11 @@ layout (location = 0) in vec3 attr_pos;
 
 out vec3 v_pos;
 
-uniform mat4 u_PROJECTION;
-uniform mat4 u_VIEW;
+layout (std140) uniform frame_data
+{
+  mat4 u_PROJECTION;
+  mat4 u_VIEW;
+};
 
 void main()
 {
@@ -736,34 +662,49 @@ void main()
 }
 )";
 
-    inline constexpr static auto* pbr_fss_ibl = R"(#version 410 core
+    inline constexpr static auto* pbr_fss = R"(#version 410 core
 layout (location = 0) out vec4 frag_color;
 
 in vec2 var_uv;
 in vec3 var_v;
 in vec3 var_n;
+
+#ifdef NORMAL_MAP
 in vec3 var_t;
 in vec3 var_b;
+uniform sampler2D s_normal;
+#endif
 
-struct light
-{
-  vec3 position;
-  vec3 color;
-};
+#ifdef VERTEX_COLORS
+in vec4 var_color;
+#endif
+
+#ifdef EMISSIVE
+uniform sampler2D s_emissive;
+#endif
+
+#ifdef OCCLUSION
+uniform sampler2D s_occlusion;
+#endif
 
-uniform float u_roughness;
-uniform float u_metalness;
-uniform vec3 u_albedo;
 uniform vec3 u_cam_pos;
 
 uniform sampler2D s_albedo;
 uniform sampler2D s_metallic_roughness;
-uniform sampler2D s_normal;
+
+#ifdef IBL
 uniform samplerCube s_ibl_diff;
 uniform samplerCube s_ibl_spec;
 uniform sampler2D s_brdf;
+#else
+struct light
+{
+  vec3 position;
+  vec3 color;
+};
 
 uniform light u_light_sources[4];
+#endif
 
 const float PI = 3.14159265359;
 
@@ -819,11 +760,17 @@ vec3 g2l(vec3 src)
 
 void main()
 {
+#ifdef NORMAL_MAP
   vec3 N = normalize(mat3(var_t, var_b, var_n) * (texture(s_normal, var_uv).xyz * 2. - 1.));
+#else
+  vec3 N = normalize(var_n);
+#endif
   vec3 V = normalize(u_cam_pos - var_v);
-  vec3 R = reflect(-V, N);
   vec3 F0 = vec3(0.04);
   vec3 albedo = texture(s_albedo, var_uv).rgb;
+#ifdef VERTEX_COLORS
+  albedo *= var_color.rgb;
+#endif
   vec4 mrao = texture(s_metallic_roughness, var_uv);
 
   float metallic = mrao.r;
@@ -831,6 +778,8 @@ void main()
 
   F0 = mix(F0, albedo, metallic);
 
+#ifdef IBL
+  vec3 R = reflect(-V, N);
   vec3 F = fresnel_schlick_roughness(max(dot(N, V), 0.0), F0, roughness);
   vec3 kS = F;
   vec3 kD = 1.0 - kS;
@@ -843,7 +792,41 @@ void main()
   vec2 brdf  = texture(s_brdf, vec2(max(dot(N, V), 0.0), roughness)).rg;
   vec3 specular = prefiltered_color * (F * brdf.x + brdf.y);
 
-  vec3 final_color = kD * diffuse + specular;
+  vec3 ambient = kD * diffuse + specular;
+  vec3 Lo = vec3(0.0);
+#else
+  vec3 ambient = albedo * 0.03;
+  vec3 Lo = vec3(0.0);
+
+  for (int i = 0; i < 4; ++i) {
+    vec3 L = normalize(u_light_sources[i].position - var_v);
+    vec3 H = normalize(V + L);
+    float dist = length(u_light_sources[i].position - var_v);
+    vec3 radiance = u_light_sources[i].color * (1. / pow(dist, 2));
+
+    vec3 F = fresnel_schlick(clamp(dot(H, V), 0.0, 1.0), F0);
+    float D = distribution_ggx(N, H, roughness);
+    float G = geometry_smith(N, V, L, roughness);
+
+    vec3 nom = F * D * G;
+    float denom = 4. * max(max(dot(N, V), 0.0) * max(dot(N, L), 0.0), 0.001);
+    vec3 BRDF = nom / denom;
+    vec3 kD = (1. - F) * (1. - metallic);
+
+    float NdotL = max(dot(N, L), 0.0);
+    Lo += (kD * albedo / PI + BRDF) * radiance * NdotL;
+  }
+#endif
+
+#ifdef OCCLUSION
+  ambient *= texture(s_occlusion, var_uv).r;
+#endif
+
+  vec3 final_color = ambient + Lo;
+
+#ifdef EMISSIVE
+  final_color += texture(s_emissive, var_uv).rgb;
+#endif
 
   frag_color = vec4(g2l(final_color), 1.);
 }
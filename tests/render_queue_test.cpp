@@ -0,0 +1,118 @@
+
+
+#include <gl/scene/render_queue.hpp>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace
+{
+    using gl::scene::render_command;
+
+    int failures = 0;
+
+
+    void check(bool condition, const char* what)
+    {
+        if (!condition) {
+            std::cerr << what << " failed" << std::endl;
+            ++failures;
+        }
+    }
+
+
+    bool equals(const render_command& l, const render_command& r)
+    {
+        return l.type == r.type && l.source_index == r.source_index && (l.type != render_command::type::blit || l.dst_index == r.dst_index);
+    }
+
+
+    // one mesh and material, the draws differ in view depth only.
+    void make_scene(gl::scene::scene& s, uint32_t drawables_count)
+    {
+        s.meshes.emplace_back(0, gl::scene::mesh::indices_type::none, 0, 3);
+        s.materials.emplace_back(0);
+
+        for (uint32_t i = 0; i < drawables_count; ++i) {
+            s.drawables.emplace_back(gl::scene::drawable{0, 0});
+        }
+    }
+} // namespace
+
+
+// pass, draws, blit, pass: the blit and the passes stay in place, only the draws between them are sorted.
+// culled draws are dropped without moving the others.
+int main()
+{
+    gl::scene::scene s;
+    make_scene(s, 4);
+
+    const std::vector<float> depths{5.f, 1.f, 3.f, 2.f};
+
+    const std::vector<render_command> commands{
+        {render_command::type::pass, 0},
+        {render_command::type::draw, 0},
+        {render_command::type::draw, 1},
+        {render_command::type::blit, 0, 1},
+        {render_command::type::draw, 2},
+        {render_command::type::pass, 1},
+        {render_command::type::draw, 3}};
+
+    gl::scene::render_queue queue(s);
+    queue.set_depth_range(0.f, 10.f);
+    queue.push_commands(commands, [&](uint32_t drawable) { return depths[drawable]; });
+    queue.sort();
+
+    check(queue.get_size() == 4, "every draw pushed");
+
+    std::vector<render_command> sorted;
+    queue.make_commands(sorted);
+
+    const std::vector<render_command> expected{
+        {render_command::type::pass, 0},
+        {render_command::type::draw, 1},
+        {render_command::type::draw, 0},
+        {render_command::type::blit, 0, 1},
+        {render_command::type::draw, 2},
+        {render_command::type::pass, 1},
+        {render_command::type::draw, 3}};
+
+    check(sorted.size() == expected.size(), "commands count");
+
+    for (size_t i = 0; i < std::min(sorted.size(), expected.size()); ++i) {
+        check(equals(sorted[i], expected[i]), "command in place");
+    }
+
+    queue.clear();
+    sorted.clear();
+    queue.make_commands(sorted);
+    check(sorted.empty(), "clear drops segments");
+
+    // culled draws are dropped, the blit and the passes are kept.
+    queue.push_commands(
+        commands,
+        [&](uint32_t drawable) { return depths[drawable]; },
+        [](uint32_t drawable) { return drawable != 2 && drawable != 3; });
+    queue.sort();
+    queue.make_commands(sorted);
+
+    const std::vector<render_command> expected_visible{
+        {render_command::type::pass, 0},
+        {render_command::type::draw, 1},
+        {render_command::type::draw, 0},
+        {render_command::type::blit, 0, 1},
+        {render_command::type::pass, 1}};
+
+    check(sorted.size() == expected_visible.size(), "visible commands count");
+
+    for (size_t i = 0; i < std::min(sorted.size(), expected_visible.size()); ++i) {
+        check(equals(sorted[i], expected_visible[i]), "visible command in place");
+    }
+
+    if (failures == 0) {
+        std::cout << "render_queue: passed" << std::endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,63 @@
+
+
+#include <worker_pool.hpp>
+
+#include <atomic>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    int failures = 0;
+
+
+    void check(bool condition, const char* what, uint32_t run)
+    {
+        if (!condition) {
+            std::cerr << what << " failed in run " << run << std::endl;
+            ++failures;
+        }
+    }
+} // namespace
+
+
+// back to back runs with few jobs, workers woken for a run often find it done and are late for the next one.
+int main()
+{
+    constexpr uint32_t runs_count = 20000;
+
+    utils::worker_pool pool(8);
+
+    for (uint32_t run = 0; run < runs_count && failures == 0; ++run) {
+        const uint32_t jobs_count = 2 + run % 7;
+
+        std::vector<std::atomic_uint32_t> calls(jobs_count);
+        std::atomic_uint32_t wrong_run{0};
+
+        pool.run(jobs_count, [&, run](uint32_t job) {
+            if (job >= jobs_count) {
+                ++wrong_run;
+                return;
+            }
+            ++calls[job];
+
+            // gives the workers of the run time to be late.
+            if (job % 3 == 0) {
+                std::this_thread::yield();
+            }
+        });
+
+        check(wrong_run == 0, "job index in range", run);
+
+        for (uint32_t job = 0; job < jobs_count; ++job) {
+            check(calls[job] == 1, "every job called once", run);
+        }
+    }
+
+    if (failures == 0) {
+        std::cout << "worker_pool: " << runs_count << " runs passed" << std::endl;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,112 @@
+
+
+#include "worker_pool.hpp"
+
+
+utils::worker_pool::worker_pool(uint32_t threads_count)
+{
+    // the calling thread takes part in every run, so one worker less is needed.
+    threads_count = std::max(threads_count, 1u) - 1;
+    m_threads.reserve(threads_count);
+
+    for (uint32_t i = 0; i < threads_count; ++i) {
+        m_threads.emplace_back([this]() { work(); });
+    }
+}
+
+
+utils::worker_pool::~worker_pool()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+
+    m_start_cv.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+
+void utils::worker_pool::run(uint32_t jobs_count, const std::function<void(uint32_t)>& f)
+{
+    if (jobs_count == 0) {
+        return;
+    }
+
+    if (m_threads.empty() || jobs_count == 1) {
+        for (uint32_t i = 0; i < jobs_count; ++i) {
+            f(i);
+        }
+        return;
+    }
+
+    auto state = std::make_shared<run_state>();
+    state->job = &f;
+    state->jobs_count = jobs_count;
+
+    {
+        std::lock_guard lock(m_mutex);
+        m_run = state;
+        ++m_generation;
+    }
+
+    m_start_cv.notify_all();
+
+    execute_jobs(*state);
+
+    std::unique_lock lock(m_mutex);
+    m_finish_cv.wait(lock, [&state]() { return state->finished_jobs == state->jobs_count; });
+    m_run.reset();
+}
+
+
+uint32_t utils::worker_pool::get_threads_count() const
+{
+    return m_threads.size() + 1;
+}
+
+
+void utils::worker_pool::work()
+{
+    uint64_t last_generation = 0;
+
+    while (true) {
+        std::shared_ptr<run_state> state;
+
+        {
+            std::unique_lock lock(m_mutex);
+            m_start_cv.wait(lock, [this, last_generation]() { return m_stop || m_generation != last_generation; });
+
+            if (m_stop) {
+                return;
+            }
+
+            last_generation = m_generation;
+            state = m_run;
+        }
+
+        // the run may be over already, its state is reset then.
+        if (state != nullptr) {
+            execute_jobs(*state);
+        }
+    }
+}
+
+
+void utils::worker_pool::execute_jobs(utils::worker_pool::run_state& state)
+{
+    uint32_t done = 0;
+
+    for (auto job = state.next_job++; job < state.jobs_count; job = state.next_job++) {
+        (*state.job)(job);
+        ++done;
+    }
+
+    if (done > 0 && state.finished_jobs.fetch_add(done) + done == state.jobs_count) {
+        std::lock_guard lock(m_mutex);
+        m_finish_cv.notify_all();
+    }
+}
@@ -0,0 +1,54 @@
+
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils
+{
+    class worker_pool
+    {
+    public:
+        explicit worker_pool(uint32_t threads_count = std::thread::hardware_concurrency());
+        ~worker_pool();
+
+        worker_pool(const worker_pool&) = delete;
+        worker_pool& operator=(const worker_pool&) = delete;
+
+        // calls f(job) for every job in [0, jobs_count) on the workers and the calling thread,
+        // returns when all jobs are done.
+        void run(uint32_t jobs_count, const std::function<void(uint32_t)>& f);
+
+        uint32_t get_threads_count() const;
+
+    private:
+        // job and counters of one run. workers hold the state of the run they were woken for,
+        // so a worker late for a run never claims or finishes jobs of the next one.
+        struct run_state
+        {
+            const std::function<void(uint32_t)>* job;
+            uint32_t jobs_count;
+            std::atomic_uint32_t next_job{0};
+            std::atomic_uint32_t finished_jobs{0};
+        };
+
+        void work();
+        void execute_jobs(run_state& state);
+
+        std::vector<std::thread> m_threads;
+
+        std::mutex m_mutex;
+        std::condition_variable m_start_cv;
+        std::condition_variable m_finish_cv;
+
+        std::shared_ptr<run_state> m_run;
+        uint64_t m_generation{0};
+        bool m_stop{false};
+    };
+} // namespace utils